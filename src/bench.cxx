@@ -1,7 +1,11 @@
+#include <map>
+#include <mutex>
 #include <atomic>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
+#include <type_traits>
 #include <signal.h>
 
 #include <fmt/format.h>
@@ -23,6 +27,15 @@
 #include "src/core/db_hint.hpp"
 #include "src/core/distribution.hpp"
 #include "src/core/operation.hpp"
+#include "src/core/latency.hpp"
+#include "src/core/pacer.hpp"
+#include "src/core/timeline.hpp"
+#include "src/core/phases.hpp"
+#include "src/core/tenants.hpp"
+#include "src/core/progress.hpp"
+#include "src/core/warmup.hpp"
+#include "src/core/statistics.hpp"
+#include "src/core/trace.hpp"
 #include "src/core/exception.hpp"
 #include "src/core/printable.hpp"
 #include "src/core/reporter.hpp"
@@ -32,6 +45,8 @@ namespace bm = benchmark;
 using namespace ucsb;
 
 using operation_chooser_ptr_t = std::unique_ptr<operation_chooser_t>;
+using worker_ptr_t = std::unique_ptr<worker_t>;
+using threads_latencies_t = std::vector<operation_latencies_t>;
 
 void parse_and_validate_args(int argc, char* argv[], settings_t& settings) {
 
@@ -50,6 +65,17 @@ void parse_and_validate_args(int argc, char* argv[], settings_t& settings) {
     program.add_argument("-fl", "--filter").default_value(std::string("")).help("Workloads filter");
     program.add_argument("-ri", "--run-index").default_value(std::string("0")).help("Run index in sequence");
     program.add_argument("-rc", "--runs-count").default_value(std::string("1")).help("Total runs count");
+    program.add_argument("-rp", "--repetitions").default_value(std::string("1")).help("Repetitions of each workload");
+    program.add_argument("-rs", "--restore-db")
+        .default_value(false)
+        .implicit_value(true)
+        .help("Restore DB files before every repetition (embedded DBs only)");
+    program.add_argument("-clk", "--clock")
+        .default_value(std::string(bench_clock_t::default_source() == clock_source_t::tsc_k ? "tsc" : "monotonic"))
+        .help("Clock source: tsc, monotonic");
+    program.add_argument("-ti", "--timeline-interval")
+        .default_value(std::string("1000"))
+        .help("Timeline sampling period in milliseconds, 0 disables the timeline");
 
     program.parse_known_args(argc, argv);
 
@@ -63,6 +89,10 @@ void parse_and_validate_args(int argc, char* argv[], settings_t& settings) {
     settings.workload_filter = program.get("filter");
     settings.run_idx = std::stoi(program.get("run-index"));
     settings.runs_count = std::stoi(program.get("runs-count"));
+    settings.repetitions = std::stoi(program.get("repetitions"));
+    settings.restore_db = program.get<bool>("restore-db");
+    settings.timeline_interval = std::stoi(program.get("timeline-interval"));
+    settings.clock_source = parse_clock_source(program.get("clock"));
 
     // Resolve paths
     auto path = program.get("main-dir");
@@ -92,6 +122,14 @@ void parse_and_validate_args(int argc, char* argv[], settings_t& settings) {
         fmt::print("Invalid run index specified\n");
         exit(1);
     }
+    if (settings.repetitions == 0) {
+        fmt::print("Zero repetitions count specified\n");
+        exit(1);
+    }
+    if (settings.clock_source == clock_source_t::unknown_k) {
+        fmt::print("Invalid clock source specified\n");
+        exit(1);
+    }
 }
 
 std::string build_title(settings_t const& settings, workloads_t const& workloads, std::string const& db_info) {
@@ -119,13 +157,18 @@ std::string build_title(settings_t const& settings, workloads_t const& workloads
 }
 
 template <typename func_at>
-inline void register_benchmark(std::string const& name, size_t threads_count, func_at func) {
-    bm::RegisterBenchmark(name.c_str(), func)
-        ->Threads(threads_count)
-        ->Unit(bm::kMicrosecond)
-        ->UseRealTime()
-        ->Repetitions(1)
-        ->Iterations(1);
+inline void register_benchmark(std::string const& name, size_t threads_count, size_t repetitions, func_at func) {
+    auto benchmark = bm::RegisterBenchmark(name.c_str(), func)
+                         ->Threads(threads_count)
+                         ->Unit(bm::kMicrosecond)
+                         ->UseManualTime()
+                         ->Repetitions(repetitions)
+                         ->Iterations(1);
+    // Note: Mean, median, stddev and cv are computed by Google Benchmark itself
+    if (repetitions > 1)
+        benchmark->ComputeStatistics("min", min_statistic)
+            ->ComputeStatistics("max", max_statistic)
+            ->ComputeStatistics("ci95", ci95_statistic);
 }
 
 void run(int argc, char* argv[], std::string const& title, size_t idx, size_t count, std::string const& results_path) {
@@ -165,12 +208,45 @@ void run(int argc, char* argv[], std::string const& title, size_t idx, size_t co
     bm::RunSpecifiedBenchmarks(&console);
 }
 
+/**
+ * @brief Threads of all tenants pass the warmup barriers and replay the trace together,
+ * so tenants can't override the warmup or trace settings of their workload.
+ */
+inline bool is_tenant_in_sync(workload_t const& workload, workload_t const& tenant) noexcept {
+    return tenant.db_warmup_operations_count == workload.db_warmup_operations_count &&
+           tenant.warmup_duration == workload.warmup_duration &&
+           tenant.steady_state_cv == workload.steady_state_cv &&
+           tenant.steady_state_max_duration == workload.steady_state_max_duration && tenant.trace_path.empty() &&
+           tenant.record_trace_path == workload.record_trace_path;
+}
+
+/**
+ * @brief Pregenerated keys are fixed before the benchmark starts,
+ * so they can't follow the keys inserted while it runs.
+ */
+inline bool is_pregeneration_supported(workload_t const& workload) noexcept {
+    if (!workload.pregenerate_keys)
+        return true;
+    bool is_following_inserts = workload.key_dist == distribution_kind_t::skewed_latest_k ||
+                                workload.key_dist == distribution_kind_t::exponential_k ||
+                                (workload.key_dist == distribution_kind_t::zipfian_k && !workload.db_operations_count);
+    return !is_following_inserts;
+}
+
 void validate_workload(workload_t const& workload, [[maybe_unused]] size_t threads_count) {
 
     assert(threads_count > 0);
     assert(!workload.name.empty());
     assert(workload.db_records_count > 0);
-    assert(workload.db_operations_count > 0);
+    [[maybe_unused]] bool is_replay = !workload.trace_path.empty();
+    [[maybe_unused]] bool is_phased = !workload.phases.empty();
+    [[maybe_unused]] bool is_multi_tenant = !workload.tenants.empty();
+    assert(workload.db_operations_count > 0 || workload.duration > 0 || is_replay || is_phased || is_multi_tenant);
+    assert(workload.duration >= 0);
+    assert(workload.db_operations_per_second >= 0);
+    assert(workload.warmup_duration >= 0);
+    assert(workload.steady_state_cv >= 0);
+    assert(workload.steady_state_cv == 0 || workload.steady_state_max_duration >= workload.warmup_duration);
 
     float proportion = 0;
     proportion += workload.upsert_proportion;
@@ -183,11 +259,22 @@ void validate_workload(workload_t const& workload, [[maybe_unused]] size_t threa
     proportion += workload.bulk_load_proportion;
     proportion += workload.range_select_proportion;
     proportion += workload.scan_proportion;
-    assert(proportion > 0.0 && proportion <= 1.0);
+    assert(is_replay || is_phased || is_multi_tenant || (proportion > 0.0 && proportion <= 1.0));
+    assert(!workload.trace_paced || is_replay);
+    assert(!is_replay || !is_phased);
+    assert(!is_multi_tenant || (!is_replay && !is_phased));
 
     assert(workload.value_length > 0);
+    assert(workload.value_compressibility >= 1.0);
+    assert(workload.key_encoding.is_valid());
 
     assert(workload.key_dist != distribution_kind_t::unknown_k);
+    assert(is_pregeneration_supported(workload));
+    assert(workload.hotspot_set_fraction > 0.0 && workload.hotspot_set_fraction <= 1.0);
+    assert(workload.hotspot_operations_fraction >= 0.0 && workload.hotspot_operations_fraction <= 1.0);
+    assert(workload.hotspot_shift_rate >= 0.0);
+    assert(workload.exponential_percentile > 0.0 && workload.exponential_percentile < 100.0);
+    assert(workload.exponential_range_fraction > 0.0);
 
     assert(workload.batch_upsert_proportion == 0.0 ||
            (workload.batch_upsert_proportion > 0.0 && workload.batch_upsert_min_length > 0));
@@ -208,6 +295,30 @@ void validate_workload(workload_t const& workload, [[maybe_unused]] size_t threa
            (workload.range_select_proportion > 0.0 && workload.range_select_min_length > 0));
     assert(workload.range_select_min_length <= workload.range_select_max_length);
     assert(workload.range_select_max_length <= workload.db_records_count / threads_count);
+
+    assert(workload.transaction_max_length == 0 || workload.transaction_min_length > 0);
+    assert(workload.transaction_min_length <= workload.transaction_max_length);
+    assert(workload.transaction_conflict_proportion >= 0.0 && workload.transaction_conflict_proportion <= 1.0);
+    assert(workload.transaction_conflict_proportion == 0.0 ||
+           (workload.transaction_conflict_keys_count > 0 &&
+            workload.transaction_conflict_keys_count <= workload.db_records_count));
+
+    for ([[maybe_unused]] auto const& phase : workload.phases) {
+        assert(phase.phases.empty());
+        assert(phase.db_records_count == workload.db_records_count);
+        assert(phase.key_encoding == workload.key_encoding);
+        validate_workload(phase, threads_count);
+    }
+
+    [[maybe_unused]] size_t tenants_threads_count = 0;
+    for ([[maybe_unused]] auto const& tenant : workload.tenants) {
+        assert(tenant.tenants.empty() && tenant.threads_count > 0);
+        assert(tenant.key_encoding == workload.key_encoding);
+        assert(is_tenant_in_sync(workload, tenant));
+        validate_workload(tenant, tenant.threads_count);
+        tenants_threads_count += tenant.threads_count;
+    }
+    assert(!is_multi_tenant || tenants_threads_count == threads_count);
 }
 
 workloads_t filter_workloads(workloads_t const& workloads, std::string const& filter) {
@@ -231,50 +342,86 @@ std::vector<workload_t> split_workload_into_threads(workload_t const& workload,
     std::vector<workload_t> workloads;
     workloads.reserve(threads_count);
 
+    // Note: Every tenant gets a contiguous range of threads, which split it as a standalone workload
+    if (!workload.tenants.empty()) {
+        for (auto const& tenant : workload.tenants) {
+            auto tenant_workloads = split_workload_into_threads(tenant, tenant.threads_count);
+            workloads.insert(workloads.end(), tenant_workloads.begin(), tenant_workloads.end());
+        }
+        return workloads;
+    }
+
     auto records_count_per_thread = workload.db_records_count / threads_count;
     auto operations_count_per_thread = workload.db_operations_count / threads_count;
     auto leftover_records_count = workload.db_records_count % threads_count;
     auto leftover_operations_count = workload.db_operations_count % threads_count;
+    auto warmup_operations_count_per_thread = workload.db_warmup_operations_count / threads_count;
+    auto leftover_warmup_operations_count = workload.db_warmup_operations_count % threads_count;
 
     auto start_key = workload.start_key;
     for (size_t idx = 0; idx < threads_count; ++idx) {
         workload_t thread_workload = workload;
         thread_workload.records_count = records_count_per_thread + bool(leftover_records_count);
         thread_workload.operations_count = operations_count_per_thread + bool(leftover_operations_count);
-        thread_workload.operations_count = std::max(size_t(1), thread_workload.operations_count);
+        // Note: Zero operations count means the workload is bounded by the duration only
+        if (workload.db_operations_count)
+            thread_workload.operations_count = std::max(size_t(1), thread_workload.operations_count);
+        thread_workload.operations_per_second = workload.db_operations_per_second / threads_count;
+        thread_workload.warmup_operations_count =
+            warmup_operations_count_per_thread + bool(leftover_warmup_operations_count);
         thread_workload.start_key = start_key;
         workloads.push_back(thread_workload);
 
         leftover_records_count -= bool(leftover_records_count);
         leftover_operations_count -= bool(leftover_operations_count);
-
-        if (workload.upsert_proportion == 1.0 || workload.batch_upsert_proportion == 1.0 ||
-            workload.bulk_load_proportion == 1.0) {
+        leftover_warmup_operations_count -= bool(leftover_warmup_operations_count);
+
+        bool is_write_only = workload.upsert_proportion == 1.0 || workload.batch_upsert_proportion == 1.0 ||
+                             workload.bulk_load_proportion == 1.0;
+        // Note: Time-based warmups insert new records as well
+        bool is_time_bounded = workload.duration > 0 || workload.warmup_duration > 0 || workload.steady_state_cv > 0;
+        if (is_write_only && is_time_bounded) {
+            // Note: The number of new keys per thread is unknown, so threads insert interleaved chunks
+            size_t chunk_length = core::interleaved_counter_generator_t::chunk_length_k;
+            workloads.back().start_key = workload.start_key + idx * chunk_length;
+            workloads.back().upsert_keys_stride = threads_count * chunk_length;
+        }
+        else if (is_write_only) {
+            // Note: Warmup operations insert new records as well
+            size_t operations_count = thread_workload.operations_count + thread_workload.warmup_operations_count;
             size_t new_records_count =
-                bool(workload.upsert_proportion) * thread_workload.operations_count +
-                bool(workload.bulk_load_proportion) * thread_workload.operations_count * workload.bulk_load_max_length +
-                bool(workload.batch_upsert_proportion) * thread_workload.operations_count *
-                    workload.batch_upsert_max_length;
+                bool(workload.upsert_proportion) * operations_count +
+                bool(workload.bulk_load_proportion) * operations_count * workload.bulk_load_max_length +
+                bool(workload.batch_upsert_proportion) * operations_count * workload.batch_upsert_max_length;
             start_key += new_records_count;
         }
         else
             start_key += workloads.back().records_count;
     }
 
+    // Note: Every thread runs its own share of every phase
+    for (size_t phase_idx = 0; phase_idx != workload.phases.size(); ++phase_idx) {
+        auto phase_workloads = split_workload_into_threads(workload.phases[phase_idx], threads_count);
+        for (size_t idx = 0; idx < threads_count; ++idx)
+            workloads[idx].phases[phase_idx] = phase_workloads[idx];
+    }
+
     return workloads;
 }
 
 db_hints_t make_hints(settings_t const& settings, workloads_t const& workloads) {
-    db_hints_t hints {settings.threads_count, 0, 0};
+    db_hints_t hints {settings.threads_count, 0, 0, {}};
     if (!workloads.empty()) {
         hints.records_count = workloads.front().db_records_count;
         hints.value_length = workloads.front().value_length;
+        hints.key_encoding = workloads.front().key_encoding;
     }
     return hints;
 }
 
-operation_chooser_ptr_t create_operation_chooser(workload_t const& workload) {
+operation_chooser_ptr_t create_operation_chooser(workload_t const& workload, core::random_engine_t& streams) {
     operation_chooser_ptr_t chooser = std::make_unique<operation_chooser_t>();
+    chooser->seed(streams);
     chooser->add(operation_kind_t::upsert_k, workload.upsert_proportion);
     chooser->add(operation_kind_t::update_k, workload.update_proportion);
     chooser->add(operation_kind_t::remove_k, workload.remove_proportion);
@@ -288,220 +435,606 @@ operation_chooser_ptr_t create_operation_chooser(workload_t const& workload) {
     return chooser;
 }
 
-struct progress_t {
-    size_t entries_touched = 0;
-    size_t bytes_processed = 0;
-
-    size_t done_iterations = 0;
-    size_t failed_iterations = 0;
-    size_t last_printed_iterations = 0;
-    size_t total_iterations = 0;
+/**
+ * @return The time point `duration` seconds after the `start`, or never if the duration isn't set.
+ */
+inline time_point_t deadline_after(time_point_t start, double duration) {
+    if (duration <= 0)
+        return time_point_t::max();
+    return start + std::chrono::duration_cast<elapsed_time_t>(std::chrono::duration<double>(duration));
+}
 
-    int64_t prev_ops_per_second = 0.0;
+/**
+ * @brief Estimated size of the DB entries, before compression.
+ * It counts the reference records only, so it doesn't account for later inserts and removals,
+ * and the disk usage it's compared to also includes logs and obsolete versions.
+ */
+inline double logical_db_size(workload_t const& workload) {
+    key_encoding_t key_encoding = key_encoder_t(workload.key_encoding).encoding();
+    double key_length = sizeof(ucsb::key_t);
+    if (key_encoding.format == key_format_t::big_endian_k)
+        key_length += key_encoding.prefix.size();
+    else if (key_encoding.format == key_format_t::string_k)
+        key_length = (key_encoding.min_length + key_encoding.max_length) / 2.0;
+    double value_length = workload.value_length;
+    if (workload.value_length_dist == distribution_kind_t::uniform_k)
+        value_length = (workload.value_length + 1) / 2.0;
+    return workload.db_records_count * (key_length + value_length);
+}
 
-    static void print_db_open() {
-        fmt::print("\33[2K\r");
-        fmt::print(" [✱] Opening DB...\r");
-        fflush(stdout);
-    }
+constexpr std::pair<hw_counters_t::event_t, char const*> hw_counters_names_k[] = {
+    {hw_counters_t::cycles_k, "cycles"},
+    {hw_counters_t::instructions_k, "instructions"},
+    {hw_counters_t::llc_loads_k, "llc_loads"},
+    {hw_counters_t::llc_misses_k, "llc_misses"},
+    {hw_counters_t::dtlb_misses_k, "dtlb_misses"},
+    {hw_counters_t::branch_misses_k, "branch_misses"},
+    {hw_counters_t::context_switches_k, "context_switches"},
+};
 
-    static void print_db_close() {
-        fmt::print("\33[2K\r");
-        fmt::print(" [✱] Closing DB...\r");
-        fflush(stdout);
+inline operation_result_t do_operation(worker_t& worker, operation_kind_t operation) {
+    switch (operation) {
+    case operation_kind_t::upsert_k: return worker.do_upsert();
+    case operation_kind_t::update_k: return worker.do_update();
+    case operation_kind_t::remove_k: return worker.do_remove();
+    case operation_kind_t::read_k: return worker.do_read();
+    case operation_kind_t::read_modify_write_k: return worker.do_read_modify_write();
+    case operation_kind_t::batch_upsert_k: return worker.do_batch_upsert();
+    case operation_kind_t::batch_read_k: return worker.do_batch_read();
+    case operation_kind_t::bulk_load_k: return worker.do_bulk_load();
+    case operation_kind_t::range_select_k: return worker.do_range_select();
+    case operation_kind_t::scan_k: return worker.do_scan();
+    case operation_kind_t::commit_k: return worker.do_commit();
     }
+    // Note: The chooser only returns known operations, so no branch is spent on checking it
+    __builtin_unreachable();
+}
 
-    static void print_db_flush() {
-        fmt::print("\33[2K\r");
-        fmt::print(" [✱] Flushing DB...\r");
-        fflush(stdout);
-    }
+template <typename>
+constexpr bool is_constant_operation_k = false;
+template <operation_kind_t kind_ak>
+constexpr bool is_constant_operation_k<std::integral_constant<operation_kind_t, kind_ak>> = true;
 
-    static void clear_last_print() {
-        fmt::print("\33[2K\r");
-        fflush(stdout);
+/**
+ * @brief Calls the `func` with the operation as a compile-time constant,
+ * so the loop of a single-operation workload is specialized for it.
+ * The constant is also a callable returning the operation, like a chooser.
+ */
+template <typename func_at>
+inline void with_constant_operation(operation_kind_t operation, func_at&& func) {
+    using kind_t = operation_kind_t;
+    switch (operation) {
+    case kind_t::upsert_k: return func(std::integral_constant<kind_t, kind_t::upsert_k> {});
+    case kind_t::update_k: return func(std::integral_constant<kind_t, kind_t::update_k> {});
+    case kind_t::remove_k: return func(std::integral_constant<kind_t, kind_t::remove_k> {});
+    case kind_t::read_k: return func(std::integral_constant<kind_t, kind_t::read_k> {});
+    case kind_t::read_modify_write_k: return func(std::integral_constant<kind_t, kind_t::read_modify_write_k> {});
+    case kind_t::batch_upsert_k: return func(std::integral_constant<kind_t, kind_t::batch_upsert_k> {});
+    case kind_t::batch_read_k: return func(std::integral_constant<kind_t, kind_t::batch_read_k> {});
+    case kind_t::bulk_load_k: return func(std::integral_constant<kind_t, kind_t::bulk_load_k> {});
+    case kind_t::range_select_k: return func(std::integral_constant<kind_t, kind_t::range_select_k> {});
+    case kind_t::scan_k: return func(std::integral_constant<kind_t, kind_t::scan_k> {});
+    case kind_t::commit_k: return func(std::integral_constant<kind_t, kind_t::commit_k> {});
     }
+}
 
-    void print_start(std::string const& workload_name) {
-        fmt::print("\33[2K\r");
-        auto name = fmt::format(fmt::fg(fmt::color::light_green), "{}", workload_name);
-        fmt::print(" [✱] {}: 0.00%\r", name, 0.0);
-        fflush(stdout);
+/**
+ * @brief Reports the throughput, duration, fails and tail latencies of a part of the workload,
+ * like a phase or a tenant, as counters starting with the `prefix`.
+ */
+template <typename stats_at>
+inline void set_part_counters(bm::State& state, std::string const& prefix, stats_at const& stats) {
+    state.counters[fmt::format("{},operations/s", prefix)] = bm::Counter(stats.operations_per_second);
+    state.counters[fmt::format("{},s", prefix)] = bm::Counter(stats.duration);
+    state.counters[fmt::format("{},fails,%", prefix)] = bm::Counter(stats.fails_percent);
+    for (size_t kind_idx = 0; kind_idx != operation_kinds_count_k; ++kind_idx) {
+        auto const& percentiles = stats.latencies[kind_idx];
+        if (!percentiles.count)
+            continue;
+        auto kind_name = operation_kind_name(operation_kind_t(kind_idx));
+        state.counters[fmt::format("{},lat_p99({}),us", prefix, kind_name)] = bm::Counter(percentiles.p99 / 1'000.0);
     }
+}
 
-    void print_end() {
-        fmt::print("\33[2K\r");
-        fmt::print(" [✱] Completed\r");
-        fflush(stdout);
+/**
+ * @brief State shared between all threads of a benchmark.
+ */
+struct shared_state_t {
+    inline shared_state_t(settings_t const& settings)
+        : threads_count(settings.threads_count), fence(settings.threads_count), progress(settings.threads_count),
+          warmup(progress), threads_latencies(settings.threads_count), threads_hw_counters(settings.threads_count),
+          timeline_interval(settings.timeline_interval), repetitions(settings.repetitions),
+          restore_db(settings.restore_db && settings.repetitions > 1), threads_trace_starts(settings.threads_count),
+          threads_traces(settings.threads_count), threads_tenants(settings.threads_count),
+          threads_end_times(settings.threads_count), threads_aborted_transactions(settings.threads_count) {
+        db_dir_paths.push_back(settings.db_main_dir_path);
+        db_dir_paths.insert(db_dir_paths.end(),
+                            settings.db_storage_dir_paths.begin(),
+                            settings.db_storage_dir_paths.end());
     }
 
-    bool is_time_to_print() {
-        auto print_iterations_step = std::max(size_t(0.05 * total_iterations), size_t(1));
-        auto done_its = atomic_load(done_iterations);
-        return done_its - atomic_load(last_printed_iterations) >= print_iterations_step || done_its == total_iterations;
+    size_t threads_count;
+    threads_fence_t fence;
+    progress_t progress;
+    warmup_monitor_t warmup;
+    threads_latencies_t threads_latencies;
+    std::vector<hw_counters_t> threads_hw_counters;
+    size_t timeline_interval;
+    std::vector<fs::path> db_dir_paths;
+    size_t repetitions;
+    size_t repetition_idx = 0;
+    bool restore_db;
+    size_t finished_threads_count = 0;
+    time_point_t start_time;
+    time_point_t deadline;
+    // Trace being replayed, opened by the first thread
+    std::unique_ptr<trace_t> trace;
+    std::vector<uint64_t> threads_trace_starts;
+    // Traces being recorded by every thread
+    std::vector<trace_records_t> threads_traces;
+    // Taken by the first thread at the start and at the end of every phase
+    phase_snapshots_t phase_snapshots;
+    // Tenants and finish times of every thread, to aggregate the stats per tenant
+    std::vector<std::string> threads_tenants;
+    std::vector<time_point_t> threads_end_times;
+    // Transactions of every thread, which were rolled back instead of committed
+    std::vector<size_t> threads_aborted_transactions;
+    // Frontiers of inserted keys, by the first new key, shared by all threads inserting there
+    std::map<ucsb::key_t, std::unique_ptr<core::acknowledged_frontier_t>> frontiers;
+    std::mutex frontiers_mutex;
+
+    inline core::acknowledged_frontier_t& frontier(ucsb::key_t start) {
+        std::lock_guard<std::mutex> lock(frontiers_mutex);
+        auto& frontier = frontiers[start];
+        if (!frontier)
+            frontier = std::make_unique<core::acknowledged_frontier_t>(start, threads_count);
+        return *frontier;
     }
+    // Bytes of the written values, shared by all threads and phases with the same value settings
+    value_pools_t value_pools;
+    // Filled by the first thread after each workload
+    file_reporter_t::extras_t results_extras;
+};
 
-    void print(std::string const& workload_name, elapsed_time_t operations_elapsed_time, elapsed_time_t elapsed_time) {
+void bench(bm::State& state,
+           workload_t const& workload,
+           db_t& db,
+           transaction_t* transaction,
+           shared_state_t& shared_state) {
 
-        auto done_percent = 100.f * done_iterations / total_iterations;
-        auto fails_percent = failed_iterations * 100.0 / done_iterations;
-        auto ops_per_second = entries_touched / std::chrono::duration<double>(operations_elapsed_time).count();
-        auto opps_delta = int64_t(ops_per_second) - prev_ops_per_second;
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed_time).count();
-        auto remaining = std::chrono::milliseconds(size_t((elapsed / done_percent) * (100.f - done_percent))).count();
+    // Note: In the transactional mode, all operations of the thread are done in its transaction
+    data_accessor_t& data_accessor = transaction ? static_cast<data_accessor_t&>(*transaction) : db;
 
-        fmt::print("\33[2K\r");
-        auto name = fmt::format(fmt::fg(fmt::color::light_green), "{}", workload_name);
-        std::string delta;
-        if (opps_delta < 0 && std::abs(opps_delta) > prev_ops_per_second * 0.0001)
-            delta = fmt::format(fmt::fg(fmt::color::red), "▼");
-        else if (opps_delta > 0 && std::abs(opps_delta) > prev_ops_per_second * 0.0001)
-            delta = fmt::format(fmt::fg(fmt::color::green), "▲");
-        auto fails = fails_percent == 0.0 ? fmt::format("{:g}%", fails_percent)
-                                          : fmt::format(fmt::fg(fmt::color::red), "{:g}%", fails_percent);
-        fmt::print(" [✱] {}: {:.2f}% [{}/s {}| fails: {} | elapsed: {} | left: {}]\r",
-                   name,
-                   done_percent,
-                   printable_float_t {ops_per_second},
-                   delta,
-                   fails,
-                   printable_duration_t {size_t(elapsed)},
-                   printable_duration_t {size_t(remaining)});
-        fflush(stdout);
+    // Note: A workload without phases is its own single phase
+    std::vector<workload_t const*> phases;
+    for (auto const& phase : workload.phases)
+        phases.push_back(&phase);
+    if (phases.empty())
+        phases.push_back(&workload);
+    bool const is_phased = !workload.phases.empty();
 
-        atomic_store(last_printed_iterations, done_iterations);
-        atomic_store(prev_ops_per_second, int64_t(ops_per_second));
+    // Bench components
+    // Note: Components of all phases are prepared before the measurements, to switch phases instantly
+    auto streams = core::random_engine_t::thread_streams(workload.seed, state.thread_index());
+    ucsb::timer_t timer(state);
+    std::vector<operation_chooser_ptr_t> choosers;
+    std::vector<pacer_t> pacers;
+    std::vector<worker_ptr_t> workers;
+    for (auto phase : phases) {
+        choosers.push_back(create_operation_chooser(*phase, streams));
+        pacers.emplace_back(phase->operations_per_second);
+        auto& frontier = shared_state.frontier(phase->db_start_key + phase->db_records_count);
+        workers.push_back(std::make_unique<worker_t>(*phase,
+                                                     data_accessor,
+                                                     timer,
+                                                     streams,
+                                                     frontier,
+                                                     shared_state.value_pools,
+                                                     state.thread_index(),
+                                                     transaction));
     }
-
-    void clear() {
-        failed_iterations = 0;
-        entries_touched = 0;
-        bytes_processed = 0;
-        done_iterations = 0;
-        last_printed_iterations = 0;
-        total_iterations = 0;
-        prev_ops_per_second = 0;
+    auto& progress = shared_state.progress;
+    auto& progress_slot = progress.slot(state.thread_index());
+    auto& threads_latencies = shared_state.threads_latencies;
+    auto& latencies = threads_latencies[state.thread_index()];
+
+    // Note: Replayed operations come from the trace instead of the chooser and generators
+    trace_cursor_t trace_cursor;
+    if (shared_state.trace)
+        trace_cursor = trace_cursor_t(shared_state.trace->records(), state.thread_index(), shared_state.threads_count);
+    bool is_trace_paced = workload.trace_paced && shared_state.trace && shared_state.trace->has_timestamps();
+
+    // Warmup
+    // Note: Operations are done as usual, but their results are discarded
+    // Note: The warmup is done once, before the first phase, and mixes operations of that phase
+    warmup_stats_t warmup_stats;
+    if (warmup_monitor_t::is_enabled(workload)) {
+        auto& chooser = choosers.front();
+        auto& pacer = pacers.front();
+        auto& worker = *workers.front();
+        progress_slot.clear();
+        atomic_store(progress_slot.total_iterations, workload.warmup_operations_count);
+        shared_state.fence.sync();
+        if (state.thread_index() == 0) {
+            shared_state.warmup.start(workload);
+            progress.start(fmt::format("{} (warmup)", workload.name));
+        }
+        shared_state.fence.sync();
+
+        timer.start();
+        pacer.start();
+        size_t warmup_iterations = 0;
+        while (warmup_iterations < workload.warmup_operations_count || !shared_state.warmup.is_done()) {
+            trace_record_t const* record = nullptr;
+            if (trace_cursor.is_enabled() && !(record = trace_cursor.next()))
+                break;
+            pacer.next();
+            auto result = record ? worker.do_replay(*record) : do_operation(worker, chooser->choose());
+            progress_slot.add(result, 0);
+            if (worker.is_transaction_complete(result))
+                worker.do_commit();
+            ++warmup_iterations;
+        }
+        if (worker.is_transaction_pending())
+            worker.do_commit();
+        timer.discard();
+
+        shared_state.fence.sync();
+        if (state.thread_index() == 0) {
+            progress.stop();
+            warmup_stats = shared_state.warmup.finish();
+        }
     }
-};
-
-void bench(bm::State& state, workload_t const& workload, db_t& db, data_accessor_t& data_accessor) {
 
-    // Bench components
-    auto chooser = create_operation_chooser(workload);
-    ucsb::timer_t timer(state);
-    worker_t worker(workload, data_accessor, timer);
-    std::atomic_bool do_flash = true;
+    progress_slot.clear();
+    latencies.clear();
+    auto& aborted_transactions = shared_state.threads_aborted_transactions[state.thread_index()];
+    aborted_transactions = 0;
+    auto commit_transaction = [&](worker_t& worker) {
+        auto commit_start_time = bench_clock_t::now();
+        aborted_transactions += worker.do_commit().status != operation_status_t::ok_k;
+        auto commit_end_time = bench_clock_t::now();
+        latencies.record(operation_kind_t::commit_k, commit_end_time - commit_start_time);
+        return commit_end_time;
+    };
 
     // Monitoring
-    cpu_profiler_t cpu_prof;    // Only one thread profiles
-    mem_profiler_t mem_prof;    // Only one thread profiles
-    static progress_t progress; // Shared between threads
+    cpu_profiler_t cpu_prof; // Only one thread profiles
+    io_profiler_t io_prof(shared_state.db_dir_paths); // Only one thread profiles
+    hw_profiler_t hw_prof;                            // Every thread profiles itself
+    mem_profiler_t mem_prof; // Only one thread profiles
+    timeline_recorder_t timeline_recorder(
+        shared_state.timeline_interval,
+        [&]() {
+            auto counters = progress.counters();
+            return timeline_counters_t {counters.entries_touched,
+                                        counters.done_iterations,
+                                        counters.failed_iterations};
+        },
+        threads_latencies);
 
     // Bench initialization
-    atomic_add_fetch(progress.total_iterations, workload.operations_count);
+    size_t operations_count = 0;
+    double duration = 0;
+    for (auto phase : phases) {
+        operations_count += phase->operations_count;
+        duration += phase->duration;
+    }
+    size_t total_iterations = operations_count;
+    if (shared_state.trace && !total_iterations)
+        total_iterations = shared_state.trace->records().size() / shared_state.threads_count;
+    atomic_store(progress_slot.total_iterations, total_iterations);
+    auto& recorded_trace = shared_state.threads_traces[state.thread_index()];
+    recorded_trace.clear();
+    if (!workload.record_trace_path.empty()) {
+        // Note: The trace is allocated upfront, so recording doesn't reallocate it in the measured loop
+        recorded_trace.reserve(operations_count);
+        for (auto& worker : workers)
+            worker->record_trace(&recorded_trace);
+    }
+    shared_state.threads_tenants[state.thread_index()] = workload.tenant;
+    // Note: Paced replay starts from the earliest record left after the warmup, among all threads
+    shared_state.threads_trace_starts[state.thread_index()] = trace_cursor.peek_timestamp();
+    // Note: Counters of all threads must be cleared before the monitoring starts sampling them
+    shared_state.fence.sync();
     if (state.thread_index() == 0) {
         cpu_prof.start();
         mem_prof.start();
-        progress.print_start(workload.name);
+        io_prof.start();
+        timeline_recorder.start();
+        progress.start(workload.name, duration);
+        shared_state.start_time = bench_clock_t::now();
+        shared_state.phase_snapshots.clear();
+        if (is_phased)
+            shared_state.phase_snapshots.push_back(take_phase_snapshot(progress, threads_latencies));
     }
+    shared_state.fence.sync();
+    // Note: Tenants may have different durations, so every thread has its own deadline
+    time_point_t deadline = deadline_after(shared_state.start_time, phases.front()->duration);
+    uint64_t const trace_start = *std::min_element(shared_state.threads_trace_starts.begin(),
+                                                   shared_state.threads_trace_starts.end());
 
     // Bench
+    hw_prof.start();
     timer.start();
-    while (state.KeepRunningBatch(workload.operations_count)) {
-        size_t thread_iterations = workload.operations_count;
-        while (thread_iterations) {
-            // Do operation
-            operation_result_t result;
-            auto operation = chooser->choose();
-            switch (operation) {
-            case operation_kind_t::upsert_k: result = worker.do_upsert(); break;
-            case operation_kind_t::update_k: result = worker.do_update(); break;
-            case operation_kind_t::remove_k: result = worker.do_remove(); break;
-            case operation_kind_t::read_k: result = worker.do_read(); break;
-            case operation_kind_t::read_modify_write_k: result = worker.do_read_modify_write(); break;
-            case operation_kind_t::batch_upsert_k: result = worker.do_batch_upsert(); break;
-            case operation_kind_t::batch_read_k: result = worker.do_batch_read(); break;
-            case operation_kind_t::bulk_load_k: result = worker.do_bulk_load(); break;
-            case operation_kind_t::range_select_k: result = worker.do_range_select(); break;
-            case operation_kind_t::scan_k: result = worker.do_scan(); break;
-            default: throw exception_t("Unknown operation"); break;
-            }
-
-            // Update progress
-            bool success = result.status == operation_status_t::ok_k;
-            auto bytes_processed = size_t(success) * workload.value_length * result.entries_touched;
-            atomic_add_fetch(progress.entries_touched, size_t(success) * result.entries_touched);
-            atomic_add_fetch(progress.failed_iterations, size_t(!success));
-            atomic_add_fetch(progress.bytes_processed, bytes_processed);
-            auto done_iterations = atomic_add_fetch(progress.done_iterations, size_t(1));
-
-            if (progress.is_time_to_print())
-                progress.print(workload.name, timer.operations_elapsed_time(), timer.elapsed_time());
-
-            // Last thread flushes the DB
-            bool only_once = true;
-            bool is_last_iteration = done_iterations == progress.total_iterations;
-            if (is_last_iteration && do_flash.compare_exchange_weak(only_once, false)) {
-                progress_t::print_db_flush();
-                db.flush();
+    while (state.KeepRunningBatch(std::max(operations_count, size_t(1)))) {
+        for (size_t phase_idx = 0; phase_idx != phases.size(); ++phase_idx) {
+            workload_t const& phase = *phases[phase_idx];
+            auto& chooser = choosers[phase_idx];
+            auto& pacer = pacers[phase_idx];
+            auto& worker = *workers[phase_idx];
+
+            // Note: Duration-bounded threads count operations dynamically, until the shared deadline
+            size_t thread_iterations = phase.operations_count ? phase.operations_count
+                                                              : std::numeric_limits<size_t>::max();
+            time_point_t operation_end_time;
+            auto run_phase = [&](auto choose) {
+                // Note: Constant operations are never replayed, so the trace checks are compiled out
+                constexpr bool is_constant = is_constant_operation_k<decltype(choose)>;
+                do {
+                    // Do operation
+                    trace_record_t const* record = nullptr;
+                    if (!is_constant && trace_cursor.is_enabled() && !(record = trace_cursor.next()))
+                        break;
+                    auto operation = record ? operation_kind_t(record->kind) : choose();
+                    // Note: In open loop the latency is measured from the intended start
+                    auto operation_start_time = !is_constant && is_trace_paced
+                                                    ? pacer.at(elapsed_time_t(record->timestamp - trace_start))
+                                                    : pacer.next();
+                    auto paused_elapsed_time = timer.paused_elapsed_time();
+                    size_t recorded_count = recorded_trace.size();
+                    operation_result_t result = record ? worker.do_replay(*record) : do_operation(worker, operation);
+                    for (size_t idx = recorded_count; idx < recorded_trace.size(); ++idx)
+                        recorded_trace[idx].timestamp = (operation_start_time - shared_state.start_time).count();
+
+                    // Note: Data preparation time (timer pauses) isn't a part of the operation latency
+                    operation_end_time = bench_clock_t::now();
+                    auto operation_elapsed_time = operation_end_time - operation_start_time;
+                    operation_elapsed_time -= timer.paused_elapsed_time() - paused_elapsed_time;
+                    latencies.record(operation, operation_elapsed_time);
+
+                    // Update progress
+                    size_t bytes_processed = phase.value_length * result.entries_touched;
+                    progress_slot.add(result, bytes_processed, is_write_operation(operation));
+
+                    // Note: The commit completes the transaction, but isn't counted as an operation
+                    if (worker.is_transaction_complete(result))
+                        operation_end_time = commit_transaction(worker);
+
+                    --thread_iterations;
+                } while (thread_iterations && operation_end_time < deadline);
+            };
+            pacer.start();
+            if (chooser->is_single() && !trace_cursor.is_enabled())
+                with_constant_operation(chooser->single(), run_phase);
+            else
+                run_phase([&]() { return chooser->choose(); });
+            // Note: The partial transaction mustn't hold its locks, while this thread waits for others
+            if (worker.is_transaction_pending())
+                commit_transaction(worker);
+
+            // Note: Threads switch to the next phase together, once the slowest one is done
+            if (!is_phased)
+                continue;
+            shared_state.fence.sync();
+            if (state.thread_index() == 0) {
+                shared_state.phase_snapshots.push_back(take_phase_snapshot(progress, threads_latencies));
+                if (phase_idx + 1 != phases.size())
+                    shared_state.deadline = deadline_after(bench_clock_t::now(), phases[phase_idx + 1]->duration);
             }
-
-            --thread_iterations;
+            shared_state.fence.sync();
+            deadline = shared_state.deadline;
+        }
+        shared_state.threads_end_times[state.thread_index()] = bench_clock_t::now();
+        hw_prof.stop();
+        shared_state.threads_hw_counters[state.thread_index()] = hw_prof.counters();
+
+        // Last thread flushes the DB
+        if (atomic_add_fetch(shared_state.finished_threads_count, size_t(1)) == shared_state.threads_count) {
+            progress_t::print_db_flush();
+            db.flush();
         }
     }
     timer.stop();
 
+    // Wait for all threads to complete their counters
+    shared_state.fence.sync();
+
     // clang-format off
 
     // Conclusion
     if (state.thread_index() == 0) {
-        progress.print_end();
+        progress.stop();
         cpu_prof.stop();
         mem_prof.stop();
+        io_prof.stop();
+        timeline_recorder.stop();
+        shared_state.finished_threads_count = 0;
+
+        auto counters = progress.counters();
+
+        hw_counters_t hw_counters = shared_state.threads_hw_counters.front();
+        for (size_t thread_idx = 1; thread_idx < shared_state.threads_count; ++thread_idx)
+            hw_counters += shared_state.threads_hw_counters[thread_idx];
+
+        operation_latencies_t merged_latencies;
+        for (auto& thread_latencies : threads_latencies)
+            merged_latencies.merge(thread_latencies);
 
         // Note: This counters are hardcoded and also used in the reporter, so if you do any change here you should also change in the reporter
-        state.SetBytesProcessed(progress.bytes_processed);
-        state.counters["fails,%"] = bm::Counter(progress.failed_iterations * 100.0 / progress.done_iterations);
-        state.counters["operations/s"] = bm::Counter(progress.entries_touched, bm::Counter::kIsRate);
+        state.SetBytesProcessed(counters.bytes_processed);
+        state.counters["fails,%"] = bm::Counter(counters.failed_iterations * 100.0 / counters.done_iterations);
+        state.counters["operations/s"] = bm::Counter(counters.entries_touched, bm::Counter::kIsRate);
         state.counters["cpu_max,%"] = bm::Counter(cpu_prof.percent().max);
         state.counters["cpu_avg,%"] = bm::Counter(cpu_prof.percent().avg);
         state.counters["mem_max(rss),bytes"] = bm::Counter(mem_prof.rss().max, bm::Counter::kDefaults, bm::Counter::kIs1024);
         state.counters["mem_avg(rss),bytes"] = bm::Counter(mem_prof.rss().avg, bm::Counter::kDefaults, bm::Counter::kIs1024);
         state.counters["mem_max(vm),bytes"] = bm::Counter(mem_prof.vm().max, bm::Counter::kDefaults, bm::Counter::kIs1024);
         state.counters["mem_avg(vm),bytes"] = bm::Counter(mem_prof.vm().avg, bm::Counter::kDefaults, bm::Counter::kIs1024);
-        state.counters["processed,bytes"] = bm::Counter(progress.bytes_processed, bm::Counter::kDefaults, bm::Counter::kIs1024);
-        state.counters["disk,bytes"] = bm::Counter(db.size_on_disk(), bm::Counter::kDefaults, bm::Counter::kIs1024);
+        state.counters["processed,bytes"] = bm::Counter(counters.bytes_processed, bm::Counter::kDefaults, bm::Counter::kIs1024);
+        size_t disk_usage = db.size_on_disk();
+        state.counters["disk,bytes"] = bm::Counter(disk_usage, bm::Counter::kDefaults, bm::Counter::kIs1024);
+        if (disk_usage)
+            state.counters["compression_ratio(est)"] = bm::Counter(logical_db_size(workload) / disk_usage);
+        auto io = io_prof.stats();
+        state.counters["io_read,bytes"] = bm::Counter(io.read_bytes, bm::Counter::kDefaults, bm::Counter::kIs1024);
+        state.counters["io_write,bytes"] = bm::Counter(io.write_bytes, bm::Counter::kDefaults, bm::Counter::kIs1024);
+        state.counters["io_read,syscalls"] = bm::Counter(io.read_syscalls);
+        state.counters["io_write,syscalls"] = bm::Counter(io.write_syscalls);
+        // Note: Without device stats (e.g. tmpfs or containers) amplification falls back to the process counters
+        size_t device_read_bytes = io.has_devices ? io.device_read_bytes : io.read_bytes;
+        size_t device_write_bytes = io.has_devices ? io.device_write_bytes : io.write_bytes;
+        if (io.has_devices) {
+            state.counters["disk_read,bytes"] = bm::Counter(io.device_read_bytes, bm::Counter::kDefaults, bm::Counter::kIs1024);
+            state.counters["disk_write,bytes"] = bm::Counter(io.device_write_bytes, bm::Counter::kDefaults, bm::Counter::kIs1024);
+            state.counters["disk_max_read,bytes/s"] = bm::Counter(io.device_max_read_bytes_per_second, bm::Counter::kDefaults, bm::Counter::kIs1024);
+            state.counters["disk_max_write,bytes/s"] = bm::Counter(io.device_max_write_bytes_per_second, bm::Counter::kDefaults, bm::Counter::kIs1024);
+        }
+        size_t logical_read_bytes = counters.bytes_processed - counters.bytes_written;
+        if (logical_read_bytes)
+            state.counters["read_amp"] = bm::Counter(double(device_read_bytes) / logical_read_bytes);
+        if (counters.bytes_written)
+            state.counters["write_amp"] = bm::Counter(double(device_write_bytes) / counters.bytes_written);
+        size_t transactions_count = merged_latencies[operation_kind_t::commit_k].count();
+        if (transactions_count) {
+            size_t aborted_transactions_count = 0;
+            for (size_t thread_aborted_transactions : shared_state.threads_aborted_transactions)
+                aborted_transactions_count += thread_aborted_transactions;
+            state.counters["transactions/s"] = bm::Counter(transactions_count, bm::Counter::kIsRate);
+            state.counters["operations/transaction"] = bm::Counter(double(counters.done_iterations) / transactions_count);
+            state.counters["aborts,%"] = bm::Counter(aborted_transactions_count * 100.0 / transactions_count);
+        }
+        if (!is_phased && workload.tenant.empty() && pacers.front().is_open_loop())
+            state.counters["target,operations/s"] = bm::Counter(workload.db_operations_per_second);
+        if (warmup_monitor_t::is_enabled(workload)) {
+            state.counters["warmup,operations"] = bm::Counter(warmup_stats.operations_count);
+            state.counters["warmup,s"] = bm::Counter(warmup_stats.duration);
+        }
+        if (workload.steady_state_cv > 0) {
+            state.counters["warmup_cv,%"] = bm::Counter(warmup_stats.throughput_cv * 100.0);
+            state.counters["warmup_steady"] = bm::Counter(warmup_stats.steady);
+        }
+        if (hw_counters.has(hw_counters_t::cycles_k) && hw_counters.has(hw_counters_t::instructions_k))
+            state.counters["ipc"] = bm::Counter(double(hw_counters[hw_counters_t::instructions_k]) / hw_counters[hw_counters_t::cycles_k]);
+        for (auto const& [event, name] : hw_counters_names_k) {
+            if (hw_counters.has(event))
+                state.counters[fmt::format("{}/op", name)] = bm::Counter(double(hw_counters[event]) / counters.done_iterations);
+        }
+        for (size_t kind_idx = 0; kind_idx != operation_kinds_count_k; ++kind_idx) {
+            auto percentiles = merged_latencies[operation_kind_t(kind_idx)].percentiles();
+            if (!percentiles.count)
+                continue;
+            auto kind_name = operation_kind_name(operation_kind_t(kind_idx));
+            state.counters[fmt::format("lat_p50({}),us", kind_name)] = bm::Counter(percentiles.p50 / 1'000.0);
+            state.counters[fmt::format("lat_p90({}),us", kind_name)] = bm::Counter(percentiles.p90 / 1'000.0);
+            state.counters[fmt::format("lat_p99({}),us", kind_name)] = bm::Counter(percentiles.p99 / 1'000.0);
+            state.counters[fmt::format("lat_p99.9({}),us", kind_name)] = bm::Counter(percentiles.p99_9 / 1'000.0);
+            state.counters[fmt::format("lat_max({}),us", kind_name)] = bm::Counter(percentiles.max / 1'000.0);
+        }
 
-        progress.clear();
+        // Note: Every repetition has its own extras, attached to its own results
+        auto& extras = shared_state.results_extras[workload.name][shared_state.repetition_idx];
+        if (is_phased) {
+            auto const& snapshots = shared_state.phase_snapshots;
+            phases_stats_t phases_stats;
+            for (size_t phase_idx = 0; phase_idx != phases.size(); ++phase_idx) {
+                phases_stats.push_back(make_phase_stats(
+                    phases[phase_idx]->name, snapshots.front(), snapshots[phase_idx], snapshots[phase_idx + 1]));
+                set_part_counters(state, fmt::format("phase_{}", phase_idx + 1), phases_stats.back());
+            }
+            extras["phases"] = phases_to_json(phases_stats);
+        }
+
+        if (!workload.tenant.empty()) {
+            auto tenants_stats = make_tenants_stats(shared_state.threads_tenants,
+                                                    shared_state.threads_end_times,
+                                                    shared_state.start_time,
+                                                    progress,
+                                                    threads_latencies);
+            for (size_t tenant_idx = 0; tenant_idx != tenants_stats.size(); ++tenant_idx)
+                set_part_counters(state, fmt::format("tenant_{}", tenant_idx + 1), tenants_stats[tenant_idx]);
+            extras["tenants"] = tenants_to_json(tenants_stats);
+        }
+
+        if (!workload.record_trace_path.empty())
+            write_trace(workload.record_trace_path, merge_traces(shared_state.threads_traces), true);
+
+        if (!timeline_recorder.timeline().empty())
+            extras["timeline"] = timeline_to_json(timeline_recorder.timeline());
     }
 
     // clang-format on
 }
 
-void bench(bm::State& state, workload_t const& workload, db_t& db, bool transactional, threads_fence_t& fence) {
+inline fs::path snapshot_dir_path(fs::path const& dir_path) {
+    // Note: Dir paths end with a slash, so the parent is the directory itself
+    return fmt::format("{}.snapshot/", dir_path.parent_path().string());
+}
+
+/**
+ * @brief Copies the DB directories aside before the first repetition
+ * and copies them back before every next one, so all repetitions start
+ * from the same DB state. The DB must be closed.
+ */
+void snapshot_or_restore_db(shared_state_t const& shared_state) {
+    for (auto const& dir_path : shared_state.db_dir_paths) {
+        auto snapshot_path = snapshot_dir_path(dir_path);
+        if (shared_state.repetition_idx == 0) {
+            fs::remove_all(snapshot_path);
+            fs::copy(dir_path, snapshot_path, fs::copy_options::recursive);
+        }
+        else {
+            fs::remove_all(dir_path);
+            fs::copy(snapshot_path, dir_path, fs::copy_options::recursive);
+        }
+    }
+}
+
+void remove_db_snapshot(shared_state_t const& shared_state) {
+    for (auto const& dir_path : shared_state.db_dir_paths)
+        fs::remove_all(snapshot_dir_path(dir_path));
+}
+
+void bench(bm::State& state, workload_t const& workload, db_t& db, bool transactional, shared_state_t& shared_state) {
 
     if (state.thread_index() == 0) {
+        if (!workload.trace_path.empty())
+            shared_state.trace = std::make_unique<trace_t>(workload.trace_path);
+        if (shared_state.restore_db)
+            snapshot_or_restore_db(shared_state);
+        // Note: Every run inserts new keys from scratch
+        shared_state.frontiers.clear();
+        // Note: Values of the previous workload are freed, so they don't count towards the DB memory
+        shared_state.value_pools.clear();
         progress_t::print_db_open();
         std::string error;
         if (!db.open(error))
             throw exception_t(error);
     }
-    fence.sync();
+    shared_state.fence.sync();
 
     if (transactional) {
         auto transaction = db.create_transaction();
         if (!transaction)
             throw exception_t("Failed to create DB transaction");
-        bench(state, workload, db, *transaction);
+        bench(state, workload, db, transaction.get(), shared_state);
     }
     else
-        bench(state, workload, db, db);
+        bench(state, workload, db, nullptr, shared_state);
 
-    fence.sync();
+    shared_state.fence.sync();
     if (state.thread_index() == 0) {
         progress_t::print_db_close();
         db.close();
         progress_t::clear_last_print();
+        shared_state.trace.reset();
+
+        ++shared_state.repetition_idx;
+        if (shared_state.repetition_idx == shared_state.repetitions) {
+            if (shared_state.restore_db)
+                remove_db_snapshot(shared_state);
+            shared_state.repetition_idx = 0;
+        }
     }
 }
 
@@ -539,6 +1072,11 @@ int main(int argc, char** argv) {
         settings_t settings;
         parse_and_validate_args(argc, argv, settings);
 
+        if (!bench_clock_t::set_source(settings.clock_source))
+            fmt::print("Invariant TSC isn't supported, falling back to monotonic clock\n");
+        if (!hw_profiler_t::is_available())
+            fmt::print("Hardware performance counters aren't accessible, check perf_event_paranoid\n");
+
         if (settings.lazy) {
             wait_for_signal(SIGUSR1);
             notify_that_benchmark_start();
@@ -599,9 +1137,57 @@ int main(int argc, char** argv) {
             fmt::print("Filter doesn't match any workload. filter: {}\n", settings.workload_filter);
             return 1;
         }
+        for (auto const& workload : workloads) {
+            if (workload.key_encoding != workloads.front().key_encoding) {
+                fmt::print("All workloads must share the same key format. workload: {}\n", workload.name);
+                return 1;
+            }
+        }
+        if (!workloads.front().key_encoding.is_valid()) {
+            fmt::print("Keys can't be longer than {} bytes, including the prefix and {} digits. workload: {}\n",
+                       key_max_length_k,
+                       key_digits_count_k,
+                       workloads.front().name);
+            return 1;
+        }
+        for (auto const& workload : workloads) {
+            std::vector<workload_t const*> nested_workloads {&workload};
+            for (auto const& phase : workload.phases)
+                nested_workloads.push_back(&phase);
+            for (auto const& tenant : workload.tenants)
+                nested_workloads.push_back(&tenant);
+            for (auto const* nested : nested_workloads) {
+                if (!is_pregeneration_supported(*nested)) {
+                    fmt::print("Pregenerated keys can't follow the inserted keys. workload: {}\n", nested->name);
+                    return 1;
+                }
+            }
+        }
+        for (auto const& workload : workloads) {
+            if (workload.tenants.empty())
+                continue;
+            size_t tenants_threads_count = 0;
+            for (auto const& tenant : workload.tenants) {
+                tenants_threads_count += tenant.threads_count;
+                if (!is_tenant_in_sync(workload, tenant)) {
+                    fmt::print("Tenants can't override warmup and trace settings. workload: {}, tenant: {}\n",
+                               workload.name,
+                               tenant.tenant);
+                    return 1;
+                }
+            }
+            if (tenants_threads_count != settings.threads_count) {
+                fmt::print("Tenants threads must add up to the threads count. workload: {}, threads: {}\n",
+                           workload.name,
+                           tenants_threads_count);
+                return 1;
+            }
+        }
         std::vector<workloads_t> threads_workloads;
         for (auto const& workload : workloads) {
             validate_workload(workload, settings.threads_count);
+            if (!workload.trace_import_path.empty())
+                import_trace(workload.trace_import_path, workload.trace_path);
             std::vector<workload_t> splitted_workloads = split_workload_into_threads(workload, settings.threads_count);
             threads_workloads.push_back(splitted_workloads);
         }
@@ -616,21 +1202,23 @@ int main(int argc, char** argv) {
         auto hints = make_hints(settings, workloads);
         db->set_config(settings.db_config_file_path, settings.db_main_dir_path, settings.db_storage_dir_paths, hints);
 
-        threads_fence_t fence(settings.threads_count);
+        shared_state_t shared_state(settings);
 
         // Register benchmarks
         for (auto const& splitted_workloads : threads_workloads) {
             std::string workload_name = splitted_workloads.front().name;
-            register_benchmark(workload_name, settings.threads_count, [&](bm::State& state) {
+            register_benchmark(workload_name, settings.threads_count, settings.repetitions, [&](bm::State& state) {
                 auto const& workload = splitted_workloads[state.thread_index()];
-                bench(state, workload, *db, settings.transactional, fence);
+                bench(state, workload, *db, settings.transactional, shared_state);
             });
         }
 
         std::string title = build_title(settings, workloads, db->info());
         run(argc, argv, title, settings.run_idx, settings.runs_count, in_progress_results_file_path);
 
-        file_reporter_t::merge_results(in_progress_results_file_path, final_results_file_path);
+        file_reporter_t::merge_results(in_progress_results_file_path,
+                                       final_results_file_path,
+                                       shared_state.results_extras);
         fs::remove(in_progress_results_file_path);
 
         if (settings.lazy) {
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <time.h>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define UCSB_HAS_TSC 1
+#endif
+
+namespace ucsb {
+
+enum class clock_source_t {
+    unknown_k,
+
+    monotonic_k,
+    tsc_k,
+};
+
+inline clock_source_t parse_clock_source(std::string const& name) {
+    clock_source_t source = clock_source_t::unknown_k;
+    if (name == "monotonic")
+        source = clock_source_t::monotonic_k;
+    else if (name == "tsc")
+        source = clock_source_t::tsc_k;
+    return source;
+}
+
+/**
+ * @brief Steady clock used for all the benchmark measurements.
+ *
+ * By default reads `CLOCK_MONOTONIC`. Optionally it can read the Time Stamp Counter
+ * directly, which is several times cheaper and matters once every single operation
+ * is timed. The TSC is only used if the CPU reports it as invariant (constant rate
+ * across frequency scaling and sleep states), and is calibrated against
+ * `CLOCK_MONOTONIC` once, when the source is selected.
+ *
+ * The default source is TSC, if compiled with `UCSB_USE_TSC_CLOCK`.
+ */
+class bench_clock_t {
+  public:
+    using duration = std::chrono::nanoseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<bench_clock_t>;
+    static constexpr bool is_steady = true;
+
+    static inline time_point now() noexcept {
+#if defined(UCSB_HAS_TSC)
+        if (use_tsc_) {
+            uint64_t delta = tsc() - base_cycles_;
+            return time_point(duration(base_nanoseconds_ + rep((__uint128_t(delta) * multiplier_) >> shift_k)));
+        }
+#endif
+        return time_point(duration(monotonic_nanoseconds()));
+    }
+
+    /**
+     * @brief Selects the clock source.
+     * @return False, if the TSC was requested, but isn't invariant,
+     * in which case the clock falls back to `CLOCK_MONOTONIC`.
+     */
+    static bool set_source(clock_source_t source) {
+        use_tsc_ = false;
+        if (source != clock_source_t::tsc_k)
+            return true;
+        if (!has_invariant_tsc())
+            return false;
+
+        calibrate();
+        use_tsc_ = true;
+        return true;
+    }
+
+    static inline clock_source_t source() noexcept {
+        return use_tsc_ ? clock_source_t::tsc_k : clock_source_t::monotonic_k;
+    }
+
+    static inline clock_source_t default_source() noexcept {
+#if defined(UCSB_USE_TSC_CLOCK)
+        return clock_source_t::tsc_k;
+#else
+        return clock_source_t::monotonic_k;
+#endif
+    }
+
+    static bool has_invariant_tsc() noexcept {
+#if defined(UCSB_HAS_TSC)
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007)
+            return false;
+        __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+        return edx & (1u << 8);
+#else
+        return false;
+#endif
+    }
+
+  private:
+    // Fixed point precision of the cycles to nanoseconds multiplier
+    static constexpr size_t shift_k = 32;
+
+    static inline rep monotonic_nanoseconds() noexcept {
+        timespec time;
+        clock_gettime(CLOCK_MONOTONIC, &time);
+        return rep(time.tv_sec) * 1'000'000'000 + time.tv_nsec;
+    }
+
+#if defined(UCSB_HAS_TSC)
+    static inline uint64_t tsc() noexcept {
+        // Note: Unlike `rdtsc`, `rdtscp` waits for all previous instructions to complete
+        unsigned aux = 0;
+        return __rdtscp(&aux);
+    }
+
+    static void calibrate() {
+        rep start_nanoseconds = monotonic_nanoseconds();
+        uint64_t start_cycles = tsc();
+        std::this_thread::sleep_for(std::chrono::milliseconds(calibration_delay_k));
+        rep end_nanoseconds = monotonic_nanoseconds();
+        uint64_t end_cycles = tsc();
+
+        double nanoseconds_per_cycle = double(end_nanoseconds - start_nanoseconds) / (end_cycles - start_cycles);
+        multiplier_ = uint64_t(nanoseconds_per_cycle * (uint64_t(1) << shift_k));
+        base_cycles_ = end_cycles;
+        base_nanoseconds_ = end_nanoseconds;
+    }
+#else
+    static void calibrate() {}
+#endif
+
+    static constexpr size_t calibration_delay_k = 50; // In milliseconds
+
+    static inline bool use_tsc_ = false;
+    static inline uint64_t multiplier_ = 0;
+    static inline uint64_t base_cycles_ = 0;
+    static inline rep base_nanoseconds_ = 0;
+};
+
+} // namespace ucsb
@@ -10,7 +10,22 @@
 
 namespace ucsb {
 
-using transaction_t = data_accessor_t;
+/**
+ * @brief A base class for transactions, each used by a single thread.
+ * Operations are applied within the current transaction, until it's committed or rolled back,
+ * and then the next one begins right away. Whatever is left is committed on destruction.
+ */
+class transaction_t : public data_accessor_t {
+  public:
+    virtual ~transaction_t() {}
+
+    /**
+     * @brief Commits the current transaction. If it conflicts with another one,
+     * it's rolled back and the status is `error_k`.
+     */
+    virtual operation_result_t commit() = 0;
+    virtual void rollback() = 0;
+};
 
 /**
  * @brief A base class for benchmarking key-value stores.
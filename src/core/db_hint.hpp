@@ -2,6 +2,8 @@
 
 #include <stddef.h>
 
+#include "src/core/key_encoding.hpp"
+
 namespace ucsb {
 
 /**
@@ -11,6 +13,7 @@ struct db_hints_t {
     size_t threads_count = 0;
     size_t records_count = 0;
     size_t value_length = 0;
+    key_encoding_t key_encoding;
 };
 
 } // namespace ucsb
\ No newline at end of file
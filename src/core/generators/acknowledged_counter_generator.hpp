@@ -1,43 +1,111 @@
 #pragma once
 
-#include <random>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <algorithm>
 
-#include "src/core/exception.hpp"
 #include "src/core/generators/counter_generator.hpp"
 
 namespace ucsb::core {
 
-class acknowledged_counter_generator_t : public counter_generator_t {
+/**
+ * @brief The frontier of inserted keys, shared by all threads of a workload.
+ * New keys are handed out in chunks, so threads reserve them without contending on every insert.
+ * Once a key is written, it's acknowledged in a ring of slots, and the last key of the contiguous
+ * acknowledged prefix is published as the high-water mark, which every reader can target.
+ *
+ * Acknowledging is lock-free: the thread filling the slot right past the frontier advances it,
+ * all the others only store their key. If a thread lags behind by more than the ring size,
+ * the frontier skips its pending keys instead of stalling. Those keys count as acknowledged,
+ * even if the lagging thread hasn't written them yet, and their late acknowledgements are dropped.
+ */
+class acknowledged_frontier_t {
   public:
-    static const size_t window_size_k = (1 << 16);
-    static const size_t window_mask_k = window_size_k - 1;
-
-    inline acknowledged_counter_generator_t(uint64_t start)
-        : counter_generator_t(start), ack_window_(window_size_k, false), limit_(start - 1) {}
+    static constexpr size_t window_size_k = (1 << 20);
+    static constexpr size_t window_mask_k = window_size_k - 1;
+    static constexpr size_t chunk_length_k = 64;
 
-    inline size_t last() override { return limit_; }
+    inline acknowledged_frontier_t(uint64_t start, size_t threads_count)
+        : slots_(new std::atomic<uint64_t>[window_size_k]), cursors_(threads_count), next_(start), limit_(start - 1) {
+        // Note: No key can be equal to the start minus one, so all slots are initially empty
+        for (size_t idx = 0; idx != window_size_k; ++idx)
+            slots_[idx].store(start - 1, std::memory_order_relaxed);
+    }
 
-    void acknowledge(uint64_t value) {
-        size_t cur_slot = value & window_mask_k;
-        if (ack_window_[cur_slot]) {
-            throw exception_t("Not enough window size");
+    inline uint64_t reserve(size_t thread_idx) noexcept {
+        cursor_t& cursor = cursors_[thread_idx];
+        if (cursor.next == cursor.end) {
+            cursor.next = next_.fetch_add(chunk_length_k, std::memory_order_relaxed);
+            cursor.end = cursor.next + chunk_length_k;
         }
-        ack_window_[cur_slot] = true;
-        size_t until = limit_ + window_size_k;
-        size_t i;
-        for (i = limit_ + 1; i < until; i++) {
-            size_t slot = i & window_mask_k;
-            if (!ack_window_[slot]) {
-                break;
-            }
-            ack_window_[slot] = false;
-        }
-        limit_ = i - 1;
+        return cursor.next++;
+    }
+
+    inline void acknowledge(uint64_t key) noexcept {
+        // Note: A skipped key may share its slot with a key of the next lap, which must not be overwritten
+        if (key <= limit_.load())
+            return;
+        // Note: Sequentially consistent accesses guarantee, that either this thread sees the frontier
+        // right before its key, or the thread advancing the frontier sees this key
+        auto& slot = slots_[key & window_mask_k];
+        uint64_t slot_key = slot.load();
+        while (slot_key < key && !slot.compare_exchange_weak(slot_key, key))
+            ;
+        uint64_t limit = limit_.load();
+        if (key > limit + window_size_k)
+            skip(limit, key - window_size_k);
+        else if (key == limit + 1)
+            advance(limit);
+    }
+
+    inline uint64_t last() const noexcept { return limit_.load(std::memory_order_acquire); }
+
+  private:
+    struct alignas(64) cursor_t {
+        uint64_t next = 0;
+        uint64_t end = 0;
+    };
+
+    inline void advance(uint64_t limit) noexcept {
+        while (slots_[(limit + 1) & window_mask_k].load() == limit + 1)
+            if (limit_.compare_exchange_weak(limit, limit + 1))
+                ++limit;
     }
 
+    inline void skip(uint64_t limit, uint64_t target) noexcept {
+        while (limit < target && !limit_.compare_exchange_weak(limit, target))
+            ;
+        advance(std::max(limit, target));
+    }
+
+    std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+    std::vector<cursor_t> cursors_;
+    alignas(64) std::atomic<uint64_t> next_;
+    alignas(64) std::atomic<uint64_t> limit_;
+};
+
+/**
+ * @brief New keys of a single thread, taken from the frontier shared with other threads.
+ * The range of existing keys follows the frontier, so it includes keys inserted by all threads.
+ */
+class acknowledged_counter_generator_t : public counter_generator_t {
+  public:
+    inline acknowledged_counter_generator_t(acknowledged_frontier_t& frontier, size_t thread_idx)
+        : counter_generator_t(0), frontier_(&frontier), thread_idx_(thread_idx) {}
+
+    inline size_t generate() override { return frontier_->reserve(thread_idx_); }
+    inline size_t last() override { return frontier_->last(); }
+    inline void generate_batch(std::span<size_t> values) override {
+        for (auto& value : values)
+            value = frontier_->reserve(thread_idx_);
+    }
+
+    inline void acknowledge(uint64_t value) noexcept { frontier_->acknowledge(value); }
+
   private:
-    std::vector<bool> ack_window_;
-    uint64_t limit_;
+    acknowledged_frontier_t* frontier_;
+    size_t thread_idx_;
 };
 
-} // namespace ucsb::core
\ No newline at end of file
+} // namespace ucsb::core
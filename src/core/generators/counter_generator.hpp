@@ -1,6 +1,7 @@
 #pragma once
 
 #include <random>
+#include <numeric>
 
 #include "src/core/generators/generator.hpp"
 
@@ -12,6 +13,10 @@ class counter_generator_t : public generator_gt<size_t> {
 
     inline size_t generate() override { return counter_++; }
     inline size_t last() override { return counter_ - 1; }
+    inline void generate_batch(std::span<size_t> values) override {
+        std::iota(values.begin(), values.end(), counter_);
+        counter_ += values.size();
+    }
 
   protected:
     size_t counter_;
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cmath>
+#include <cassert>
+
+#include "src/core/generators/counter_generator.hpp"
+
+namespace ucsb::core {
+
+/**
+ * @brief Exponentially distributed keys, the latest inserted being the most frequent, like in YCSB:
+ * `percentile` percent of requests fall into the last `range_fraction` of the initial range,
+ * counted back from the last inserted key. Samples before the first key are drawn again.
+ */
+class exponential_generator_t : public generator_gt<size_t> {
+  public:
+    inline exponential_generator_t(
+        size_t min, size_t items_count, double percentile, double range_fraction, counter_generator_t& counter)
+        : basis_(&counter), min_(min), gamma_(-std::log(1.0 - percentile / 100.0) / (items_count * range_fraction)),
+          last_(0) {
+        assert(percentile > 0.0 && percentile < 100.0 && range_fraction > 0.0);
+        generate();
+    }
+
+    inline size_t generate() override { return last_ = next(basis_->last()); }
+    inline size_t last() override { return last_; }
+    inline void seed(random_engine_t& streams) override { engine_ = streams.split(); }
+    inline void generate_batch(std::span<size_t> values) override {
+        size_t max = basis_->last();
+        for (auto& value : values)
+            value = next(max);
+        if (!values.empty())
+            last_ = values.back();
+    }
+
+  private:
+    inline size_t next(size_t max) noexcept {
+        assert(max >= min_);
+        double distance = 0;
+        do
+            distance = -std::log(1.0 - engine_.next_double()) / gamma_;
+        while (distance > max - min_);
+        return max - size_t(distance);
+    }
+
+    random_engine_t engine_;
+    counter_generator_t* basis_;
+    size_t min_;
+    double gamma_;
+    size_t last_;
+};
+
+} // namespace ucsb::core
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <span>
+
 #include "src/core/types.hpp"
+#include "src/core/generators/random_engine.hpp"
 
 namespace ucsb::core {
 
@@ -13,6 +16,21 @@ class generator_gt {
 
     virtual value_t generate() = 0;
     virtual value_t last() = 0;
+
+    /**
+     * @brief Takes independent random streams, by splitting them off the `streams`.
+     * Deterministic generators ignore it.
+     */
+    virtual void seed(random_engine_t&) {}
+
+    /**
+     * @brief Fills all the `values` with a single virtual call, instead of one per value.
+     * Overrides may also do their per-call work, like range updates, once per batch.
+     */
+    virtual void generate_batch(std::span<value_t> values) {
+        for (auto& value : values)
+            value = generate();
+    }
 };
 
 } // namespace ucsb::core
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+
+#include "src/core/generators/generator.hpp"
+
+namespace ucsb::core {
+
+/**
+ * @brief Sends `hot_operations_fraction` of requests to a hot set of `hot_set_fraction` of the range,
+ * and the rest uniformly to the other keys. The hot set moves forward by `shift_rate` keys after
+ * every generated key, wrapping around the range, so a non-zero rate makes the working set drift.
+ */
+class hotspot_generator_t : public generator_gt<size_t> {
+  public:
+    inline hotspot_generator_t(
+        size_t min, size_t max, double hot_set_fraction, double hot_operations_fraction, double shift_rate = 0)
+        : base_(min), items_count_(max - min + 1),
+          hot_count_(std::clamp<size_t>(items_count_ * hot_set_fraction, 1, items_count_)),
+          cold_count_(std::max<size_t>(items_count_ - hot_count_, 1)),
+          hot_operations_fraction_(hot_count_ == items_count_ ? 1.0 : hot_operations_fraction),
+          shift_rate_(std::fmod(shift_rate, double(items_count_))), offset_(0), last_(0) {
+        generate();
+    }
+
+    inline size_t generate() override { return last_ = next(); }
+    inline size_t last() override { return last_; }
+    inline void seed(random_engine_t& streams) override { engine_ = streams.split(); }
+    inline void generate_batch(std::span<size_t> values) override {
+        for (auto& value : values)
+            value = next();
+        if (!values.empty())
+            last_ = values.back();
+    }
+
+  private:
+    inline size_t next() noexcept {
+        size_t hot_start = size_t(offset_);
+        offset_ += shift_rate_;
+        offset_ -= offset_ >= items_count_ ? items_count_ : 0;
+
+        bool is_hot = engine_.next_double() < hot_operations_fraction_;
+        size_t hot_idx = engine_() % hot_count_;
+        size_t cold_idx = hot_count_ + engine_() % cold_count_;
+        size_t position = hot_start + (is_hot ? hot_idx : cold_idx);
+        position -= position >= items_count_ ? items_count_ : 0;
+        return base_ + position;
+    }
+
+    random_engine_t engine_;
+    size_t base_;
+    size_t items_count_;
+    size_t hot_count_;
+    size_t cold_count_;
+    double hot_operations_fraction_;
+    double shift_rate_;
+    double offset_;
+    size_t last_;
+};
+
+} // namespace ucsb::core
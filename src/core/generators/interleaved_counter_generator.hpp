@@ -0,0 +1,40 @@
+#pragma once
+
+#include "src/core/generators/generator.hpp"
+
+namespace ucsb::core {
+
+/**
+ * @brief Counts through chunks of `chunk_length` consecutive values, which are `chunks_stride` apart.
+ * Several threads with different starts can insert new keys without knowing
+ * in advance how many each of them will insert, keeping the whole key space dense.
+ */
+class interleaved_counter_generator_t : public generator_gt<size_t> {
+  public:
+    static constexpr size_t chunk_length_k = 1024;
+
+    inline interleaved_counter_generator_t(size_t start, size_t chunks_stride, size_t chunk_length = chunk_length_k)
+        : start_(start), chunks_stride_(chunks_stride), chunk_length_(chunk_length), counter_(0), last_(start - 1) {}
+
+    inline size_t generate() override { return generate_next(); }
+    inline size_t last() override { return last_; }
+    inline void generate_batch(std::span<size_t> values) override {
+        for (auto& value : values)
+            value = generate_next();
+    }
+
+  private:
+    inline size_t generate_next() noexcept {
+        last_ = start_ + (counter_ / chunk_length_) * chunks_stride_ + counter_ % chunk_length_;
+        ++counter_;
+        return last_;
+    }
+
+    size_t start_;
+    size_t chunks_stride_;
+    size_t chunk_length_;
+    size_t counter_;
+    size_t last_;
+};
+
+} // namespace ucsb::core
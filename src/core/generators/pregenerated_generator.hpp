@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+#include <cstring>
+#include <algorithm>
+
+#include "src/core/huge_buffer.hpp"
+#include "src/core/generators/generator.hpp"
+
+namespace ucsb::core {
+
+/**
+ * @brief Materializes the sequence of another generator before the benchmark starts,
+ * so the measured loop only reads the next slot, instead of evaluating the distribution.
+ * The sequence is stored in a huge-page-backed buffer and is repeated once exhausted.
+ */
+class pregenerated_generator_t : public generator_gt<size_t> {
+  public:
+    inline pregenerated_generator_t(std::unique_ptr<generator_gt<size_t>> generator, size_t count)
+        : generator_(std::move(generator)), count_(std::max<size_t>(count, 1)), buffer_(count_ * sizeof(size_t)),
+          values_(reinterpret_cast<size_t*>(buffer_.data())), position_(0), last_(0) {
+        for (size_t i = 0; i != count_; ++i)
+            values_[i] = generator_->generate();
+    }
+
+    inline size_t generate() override {
+        last_ = values_[position_];
+        position_ = position_ + 1 == count_ ? 0 : position_ + 1;
+        return last_;
+    }
+    inline size_t last() override { return last_; }
+    /**
+     * @brief The sequence is already materialized, so the wrapped generator must be seeded before.
+     */
+    inline void seed(random_engine_t&) override {}
+    inline void generate_batch(std::span<size_t> values) override {
+        for (size_t copied = 0; copied != values.size();) {
+            size_t count = std::min(values.size() - copied, count_ - position_);
+            std::memcpy(values.data() + copied, values_ + position_, count * sizeof(size_t));
+            copied += count;
+            position_ = position_ + count == count_ ? 0 : position_ + count;
+        }
+        if (!values.empty())
+            last_ = values.back();
+    }
+
+  private:
+    std::unique_ptr<generator_gt<size_t>> generator_;
+    size_t count_;
+    huge_buffer_t buffer_;
+    size_t* values_;
+    size_t position_;
+    size_t last_;
+};
+
+} // namespace ucsb::core
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ucsb::core {
+
+/**
+ * @brief xoshiro256** pseudo-random engine, shared by all generators.
+ * Satisfies `UniformRandomBitGenerator`, so it can drive standard distributions.
+ *
+ * Independent streams are derived from a single seed by jumping ahead:
+ * `long_jump()` separates threads by 2^192 values and `jump()` separates
+ * generators of the same thread by 2^128 values, so streams never overlap
+ * and a run with the same seed and threads count is reproducible.
+ */
+class random_engine_t {
+  public:
+    using result_type = uint64_t;
+
+    static constexpr result_type min() noexcept { return 0; }
+    static constexpr result_type max() noexcept { return UINT64_MAX; }
+
+    inline random_engine_t(uint64_t seed = 0) noexcept {
+        // Note: SplitMix64 spreads even small seeds over the whole state, which must not be all zeros
+        for (auto& word : state_) {
+            seed += 0x9E3779B97F4A7C15ull;
+            uint64_t mixed = seed;
+            mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+            mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+            word = mixed ^ (mixed >> 31);
+        }
+    }
+
+    /**
+     * @brief Streams of a single thread, to be `split()` between its generators.
+     */
+    static inline random_engine_t thread_streams(uint64_t seed, size_t thread_idx) noexcept {
+        random_engine_t engine(seed);
+        for (size_t i = 0; i != thread_idx; ++i)
+            engine.long_jump();
+        return engine;
+    }
+
+    inline result_type operator()() noexcept {
+        uint64_t result = rotl(state_[1] * 5, 7) * 9;
+        uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+        return result;
+    }
+
+    /**
+     * @brief Uniform value in [0, 1), using the upper 24 bits.
+     */
+    inline float next_float() noexcept { return ((*this)() >> 40) * 0x1.0p-24f; }
+    /**
+     * @brief Uniform value in [0, 1), using the upper 53 bits.
+     */
+    inline double next_double() noexcept { return ((*this)() >> 11) * 0x1.0p-53; }
+
+    /**
+     * @brief Returns the current stream and advances this one to the next independent stream.
+     */
+    inline random_engine_t split() noexcept {
+        random_engine_t stream = *this;
+        jump();
+        return stream;
+    }
+
+    inline void jump() noexcept {
+        constexpr uint64_t polynomial_k[] = {
+            0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull};
+        jump(polynomial_k);
+    }
+    inline void long_jump() noexcept {
+        constexpr uint64_t polynomial_k[] = {
+            0x76E15D3EFEFDCBBFull, 0xC5004E441C522FB3ull, 0x77710069854EE241ull, 0x39109BB02ACBE635ull};
+        jump(polynomial_k);
+    }
+
+  private:
+    static inline uint64_t rotl(uint64_t value, int shift) noexcept {
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+    inline void jump(uint64_t const (&polynomial)[4]) noexcept {
+        uint64_t state[4] = {0, 0, 0, 0};
+        for (uint64_t word : polynomial)
+            for (int bit = 0; bit != 64; ++bit) {
+                if (word & (uint64_t(1) << bit))
+                    for (int i = 0; i != 4; ++i)
+                        state[i] ^= state_[i];
+                (*this)();
+            }
+        for (int i = 0; i != 4; ++i)
+            state_[i] = state[i];
+    }
+
+    uint64_t state_[4];
+};
+
+} // namespace ucsb::core
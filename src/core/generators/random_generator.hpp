@@ -1,39 +1,35 @@
 #pragma once
 
-#include <random>
-
 #include "src/core/generators/generator.hpp"
 
 namespace ucsb::core {
 
 class random_int_generator_t final : public generator_gt<uint32_t> {
   public:
-    inline random_int_generator_t() : device_(), rand_(device_()), last_(0) { generate(); }
+    inline random_int_generator_t() : last_(0) { generate(); }
 
-    inline uint32_t generate() override { return last_ = rand_(); }
+    inline uint32_t generate() override { return last_ = uint32_t(engine_() >> 32); }
     inline uint32_t last() override { return last_; }
+    inline void seed(random_engine_t& streams) override { engine_ = streams.split(); }
 
   private:
-    std::random_device device_;
-    std::minstd_rand rand_;
-    float last_;
+    random_engine_t engine_;
+    uint32_t last_;
 };
 
 class random_double_generator_t final : public generator_gt<float> {
   public:
-    inline random_double_generator_t(float min, float max)
-        : device_(), rand_(device_()), uniform_(min, max), last_(0.0) {
-        generate();
-    }
+    inline random_double_generator_t(float min, float max) : min_(min), range_(max - min), last_(0.0) { generate(); }
     ~random_double_generator_t() override = default;
 
-    inline float generate() override { return last_ = uniform_(rand_); }
+    inline float generate() override { return last_ = min_ + engine_.next_float() * range_; }
     inline float last() override { return last_; }
+    inline void seed(random_engine_t& streams) override { engine_ = streams.split(); }
 
   private:
-    std::random_device device_;
-    std::minstd_rand rand_;
-    std::uniform_real_distribution<float> uniform_;
+    random_engine_t engine_;
+    float min_;
+    float range_;
     float last_;
 };
 
@@ -44,6 +40,10 @@ class random_byte_generator_t final : public generator_gt<char> {
 
     inline char generate() override;
     inline char last() override { return buf_[(off_ - 1 + 6) % 6]; }
+    inline void seed(random_engine_t& streams) override {
+        generator_.seed(streams);
+        off_ = 6;
+    }
 
   private:
     random_int_generator_t generator_;
@@ -66,4 +66,4 @@ inline char random_byte_generator_t::generate() {
     return buf_[off_++];
 }
 
-} // namespace ucsb::core
\ No newline at end of file
+} // namespace ucsb::core
@@ -2,26 +2,45 @@
 
 #include <cassert>
 
+#include "src/core/generators/counter_generator.hpp"
 #include "src/core/generators/zipfian_generator.hpp"
 
 namespace ucsb::core {
 
+/**
+ * @brief Zipfian popularity over a fixed space of `items_count_k` items, hashed into the range,
+ * so the popular items are spread all over the range instead of clustering at its start.
+ */
 class scrambled_zipfian_generator_t : public generator_gt<size_t> {
   public:
-    inline scrambled_zipfian_generator_t(size_t min, size_t max, float zipfian_const)
-        : base_(min), num_items_(max - min + 1), generator_(0, 10'000'000'000LL, zipfian_const) {}
-    inline scrambled_zipfian_generator_t(size_t min, size_t max)
-        : base_(min), num_items_(max - min + 1),
-          generator_(0, 10'000'000'000LL, zipfian_generator_t::zipfian_const_k, zetan_k) {}
+    static constexpr size_t items_count_k = 10'000'000'000ull;
+
+    inline scrambled_zipfian_generator_t(size_t min,
+                                         size_t max,
+                                         double zipfian_const = zipfian_generator_t::zipfian_const_k)
+        : base_(min), num_items_(max - min + 1), basis_(nullptr), generator_(0, items_count_k - 1, zipfian_const) {}
     inline scrambled_zipfian_generator_t(size_t num_items) : scrambled_zipfian_generator_t(0, num_items - 1) {}
+    /**
+     * @brief The range grows with the `basis` counter, from `min` up to its last value.
+     * Used when the number of inserted keys isn't known in advance.
+     */
+    inline scrambled_zipfian_generator_t(size_t min, counter_generator_t& basis)
+        : base_(min), num_items_(0), basis_(&basis),
+          generator_(0, items_count_k - 1) {}
 
     inline size_t generate() override { return scramble(generator_.generate()); }
     inline size_t last() override { return scramble(generator_.last()); }
+    inline void seed(random_engine_t& streams) override { generator_.seed(streams); }
+    inline void generate_batch(std::span<size_t> values) override {
+        generator_.generate_batch(values);
+        size_t num_items = this->num_items();
+        for (auto& value : values)
+            value = base_ + fnv_hash64(value) % num_items;
+    }
 
   private:
-    static constexpr float zetan_k = 26.46902820178302;
-
-    inline size_t scramble(size_t value) const noexcept { return base_ + fnv_hash64(value) % num_items_; }
+    inline size_t num_items() const noexcept { return basis_ ? basis_->last() - base_ + 1 : num_items_; }
+    inline size_t scramble(size_t value) const noexcept { return base_ + fnv_hash64(value) % num_items(); }
 
     inline size_t fnv_hash64(size_t val) const noexcept {
         size_t constexpr fnv_offset_basis64 = 0xCBF29CE484222325ull;
@@ -39,6 +58,7 @@ class scrambled_zipfian_generator_t : public generator_gt<size_t> {
 
     size_t const base_;
     size_t const num_items_;
+    counter_generator_t* const basis_;
     zipfian_generator_t generator_;
 };
 
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <numeric>
+#include <algorithm>
+
+#include "src/core/generators/generator.hpp"
+
+namespace ucsb::core {
+
+/**
+ * @brief Walks the range key by key, starting over once it reaches the end.
+ */
+class sequential_generator_t : public generator_gt<size_t> {
+  public:
+    inline sequential_generator_t(size_t min, size_t max)
+        : base_(min), items_count_(max - min + 1), position_(0), last_(min) {}
+
+    inline size_t generate() override {
+        last_ = base_ + position_;
+        position_ = position_ + 1 == items_count_ ? 0 : position_ + 1;
+        return last_;
+    }
+    inline size_t last() override { return last_; }
+    inline void generate_batch(std::span<size_t> values) override {
+        for (size_t filled = 0; filled != values.size();) {
+            size_t count = std::min(values.size() - filled, items_count_ - position_);
+            std::iota(values.begin() + filled, values.begin() + filled + count, base_ + position_);
+            filled += count;
+            position_ = position_ + count == items_count_ ? 0 : position_ + count;
+        }
+        if (!values.empty())
+            last_ = values.back();
+    }
+
+  private:
+    size_t base_;
+    size_t items_count_;
+    size_t position_;
+    size_t last_;
+};
+
+} // namespace ucsb::core
@@ -13,6 +13,8 @@ class skewed_latest_generator_t : public generator_gt<size_t> {
 
     inline size_t generate() override;
     inline size_t last() override { return last_; }
+    inline void seed(random_engine_t& streams) override { zipfian_.seed(streams); }
+    inline void generate_batch(std::span<size_t> values) override;
 
   private:
     counter_generator_t* basis_;
@@ -26,4 +28,14 @@ inline size_t skewed_latest_generator_t::generate() {
     return last_ = max - zipfian_.generate(max);
 }
 
+inline void skewed_latest_generator_t::generate_batch(std::span<size_t> values) {
+    if (values.empty())
+        return;
+    size_t max = basis_->last();
+    zipfian_.generate_batch(values, max);
+    for (auto& value : values)
+        value = max - value;
+    last_ = values.back();
+}
+
 } // namespace ucsb::core
\ No newline at end of file
@@ -15,9 +15,16 @@ class uniform_generator_gt : public generator_gt<value_at> {
     inline uniform_generator_gt(value_t min, value_t max) : dist_(min, max), last_(0) { generate(); }
     inline value_t generate() override { return last_ = dist_(generator_); }
     inline value_t last() override { return last_; }
+    inline void seed(random_engine_t& streams) override { generator_ = streams.split(); }
+    inline void generate_batch(std::span<value_t> values) override {
+        for (auto& value : values)
+            value = dist_(generator_);
+        if (!values.empty())
+            last_ = values.back();
+    }
 
   private:
-    std::mt19937_64 generator_;
+    random_engine_t generator_;
     std::uniform_int_distribution<value_t> dist_;
     value_t last_;
 };
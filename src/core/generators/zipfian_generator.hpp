@@ -1,88 +1,148 @@
 #pragma once
 
-#include <random>
+#include <span>
+#include <cmath>
+#include <algorithm>
 #include <cassert>
 
 #include "src/core/generators/generator.hpp"
-#include "src/core/generators/random_generator.hpp"
 
 namespace ucsb::core {
 
+/**
+ * @brief Zipfian distributed values in the range, the smallest being the most frequent, like in YCSB.
+ * The number of items may change between calls, so zeta is maintained incrementally:
+ * terms of the first items are summed exactly, and terms past them, in steps of any length,
+ * use the Euler-Maclaurin approximation, so the construction and any resize take O(1)
+ * even for billions of items.
+ */
 class zipfian_generator_t : public generator_gt<size_t> {
   public:
-    static constexpr float zipfian_const_k = 0.99;
+    static constexpr double zipfian_const_k = 0.99;
     static constexpr size_t items_max_count = (UINT64_MAX >> 24);
 
     zipfian_generator_t(size_t items_count) : zipfian_generator_t(0, items_count - 1) {}
-    zipfian_generator_t(size_t min, size_t max, float zipfian_const = zipfian_const_k)
-        : zipfian_generator_t(min, max, zipfian_const, zeta(max - min + 1, zipfian_const)) {}
-    zipfian_generator_t(size_t min, size_t max, float zipfian_const, float zeta_n);
+    zipfian_generator_t(size_t min, size_t max, double zipfian_const = zipfian_const_k);
 
     inline size_t generate() override { return generate(items_count_); }
     inline size_t last() override { return last_; }
+    inline void seed(random_engine_t& streams) override { engine_ = streams.split(); }
+    inline void generate_batch(std::span<size_t> values) override { generate_batch(values, items_count_); }
 
     size_t generate(size_t items_count);
+    void generate_batch(std::span<size_t> values, size_t items_count);
 
   private:
-    inline float eta() { return (1 - std::pow(2.f / items_count_, 1 - theta_)) / (1 - zeta_2_ / zeta_n_); }
-    inline float zeta(size_t num, float theta) { return zeta(0, num, theta, 0.f); }
-    inline float zeta(size_t last_num, size_t cur_num, float theta, float last_zeta);
+    static constexpr size_t batch_chunk_length_k = 64;
+    /**
+     * @brief Terms up to this item are summed one by one, and the rest are approximated.
+     * Past it, the relative error of the approximation is far below the double precision.
+     */
+    static constexpr size_t exact_zeta_length_k = 1024;
+
+    inline void update_zeta(size_t num);
+    inline double eta() const noexcept {
+        return (1 - std::pow(2.0 / count_for_zeta_, 1 - theta_)) / (1 - zeta_2_ / zeta_n_);
+    }
+    inline double zeta(size_t num) const noexcept { return zeta(0, num); }
+    inline double zeta(size_t last_num, size_t cur_num) const noexcept;
 
-    random_double_generator_t generator_;
+    random_engine_t engine_;
     size_t items_count_;
     size_t base_;
     size_t count_for_zeta_;
     size_t last_;
-    float theta_;
-    float zeta_n_;
-    float eta_;
-    float alpha_;
-    float zeta_2_;
-    bool allow_count_decrease_;
+    double theta_;
+    double zeta_n_;
+    double eta_;
+    double alpha_;
+    double zeta_2_;
+    double second_threshold_;
 };
 
-zipfian_generator_t::zipfian_generator_t(size_t min, size_t max, float zipfian_const, float zeta_n)
-    : generator_(0.0, 1.0), items_count_(max - min + 1), base_(min), theta_(zipfian_const),
-      allow_count_decrease_(false) {
+zipfian_generator_t::zipfian_generator_t(size_t min, size_t max, double zipfian_const)
+    : items_count_(max - min + 1), base_(min), last_(0), theta_(zipfian_const) {
     assert(items_count_ >= 2 && items_count_ < items_max_count);
+    assert(theta_ > 0 && theta_ != 1);
 
-    zeta_2_ = zeta(2, theta_);
+    zeta_2_ = zeta(2);
     alpha_ = 1.0 / (1.0 - theta_);
-    zeta_n_ = zeta_n;
+    zeta_n_ = zeta(items_count_);
     count_for_zeta_ = items_count_;
     eta_ = eta();
+    second_threshold_ = 1.0 + std::pow(0.5, theta_);
 
     generate();
 }
 
+inline void zipfian_generator_t::update_zeta(size_t num) {
+    if (num == count_for_zeta_)
+        return;
+    if (num > count_for_zeta_)
+        zeta_n_ += zeta(count_for_zeta_, num);
+    else
+        zeta_n_ -= zeta(num, count_for_zeta_);
+    count_for_zeta_ = num;
+    eta_ = eta();
+}
+
 size_t zipfian_generator_t::generate(size_t num) {
     assert(num >= 2 && num < items_max_count);
-    if (num != count_for_zeta_) {
-        if (num > count_for_zeta_) {
-            zeta_n_ = zeta(count_for_zeta_, num, theta_, zeta_n_);
-            count_for_zeta_ = num;
-            eta_ = eta();
-        }
-        else if (num < count_for_zeta_ && allow_count_decrease_) {
-            // TODO
-        }
-    }
+    update_zeta(num);
 
-    float u = generator_.generate();
-    float uz = u * zeta_n_;
+    double u = engine_.next_double();
+    double uz = u * zeta_n_;
 
     if (uz < 1.0)
         return last_ = base_;
-    if (uz < 1.0 + std::pow(0.5, theta_))
+    if (uz < second_threshold_)
         return last_ = base_ + 1;
-    return last_ = base_ + num * std::pow(eta_ * u - eta_ + 1, alpha_);
+    return last_ = base_ + size_t(num * std::pow(eta_ * u - eta_ + 1, alpha_));
+}
+
+/**
+ * @brief Draws the uniform samples of a chunk first, and then evaluates
+ * the inverse CDF of the whole chunk at once, without branches.
+ */
+void zipfian_generator_t::generate_batch(std::span<size_t> values, size_t num) {
+    assert(num >= 2 && num < items_max_count);
+    if (values.empty())
+        return;
+    update_zeta(num);
+
+    double samples[batch_chunk_length_k];
+    for (size_t offset = 0; offset < values.size(); offset += batch_chunk_length_k) {
+        size_t count = std::min(values.size() - offset, batch_chunk_length_k);
+        for (size_t i = 0; i != count; ++i)
+            samples[i] = engine_.next_double();
+        for (size_t i = 0; i != count; ++i) {
+            double u = samples[i];
+            double uz = u * zeta_n_;
+            size_t value = base_ + size_t(num * std::pow(eta_ * u - eta_ + 1, alpha_));
+            value = uz < second_threshold_ ? base_ + 1 : value;
+            values[offset + i] = uz < 1.0 ? base_ : value;
+        }
+    }
+    last_ = values.back();
 }
 
-inline float zipfian_generator_t::zeta(size_t last_num, size_t cur_num, float theta, float last_zeta) {
-    float zeta = last_zeta;
-    for (size_t i = last_num + 1; i <= cur_num; ++i)
-        zeta += 1 / std::pow(i, theta);
+/**
+ * @return The sum of `1 / i^theta` for `i` in `(last_num, cur_num]`.
+ */
+inline double zipfian_generator_t::zeta(size_t last_num, size_t cur_num) const noexcept {
+    double zeta = 0;
+    size_t exact_num = std::min(cur_num, std::max(last_num, exact_zeta_length_k));
+    for (size_t i = last_num + 1; i <= exact_num; ++i)
+        zeta += 1 / std::pow(double(i), theta_);
+    if (exact_num == cur_num)
+        return zeta;
+
+    // Note: Euler-Maclaurin, with f(x) = x^-theta: the integral, the endpoints and the derivatives correction
+    double from = exact_num, to = cur_num;
+    zeta += (std::pow(to, 1 - theta_) - std::pow(from, 1 - theta_)) / (1 - theta_);
+    zeta += (std::pow(to, -theta_) - std::pow(from, -theta_)) / 2;
+    zeta -= theta_ * (std::pow(to, -theta_ - 1) - std::pow(from, -theta_ - 1)) / 12;
     return zeta;
 }
 
-} // namespace ucsb::core
\ No newline at end of file
+} // namespace ucsb::core
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <sys/mman.h>
+#include <cstddef>
+#include <utility>
+
+#include "src/core/helper.hpp"
+#include "src/core/exception.hpp"
+
+namespace ucsb {
+
+/**
+ * @brief Anonymous memory region, backed by transparent huge pages if possible.
+ * Used for large buffers streamed by the benchmark loop, to avoid TLB misses.
+ */
+class huge_buffer_t {
+  public:
+    static constexpr size_t huge_page_size_k = 2 * 1024 * 1024;
+
+    inline huge_buffer_t() noexcept : data_(nullptr), size_(0) {}
+    inline huge_buffer_t(size_t size) : data_(nullptr), size_(roundup_to_multiple<huge_page_size_k>(size)) {
+        void* data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED)
+            throw exception_t("Failed to allocate huge pages buffer");
+        madvise(data, size_, MADV_HUGEPAGE);
+        data_ = reinterpret_cast<std::byte*>(data);
+    }
+    ~huge_buffer_t() {
+        if (data_)
+            munmap(data_, size_);
+    }
+
+    huge_buffer_t(huge_buffer_t const&) = delete;
+    huge_buffer_t& operator=(huge_buffer_t const&) = delete;
+    inline huge_buffer_t(huge_buffer_t&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+    inline huge_buffer_t& operator=(huge_buffer_t&& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    inline size_t size() const noexcept { return size_; }
+    inline std::byte* data() noexcept { return data_; }
+    inline std::byte const* data() const noexcept { return data_; }
+
+  private:
+    std::byte* data_;
+    size_t size_;
+};
+
+} // namespace ucsb
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <string_view>
+
+#include "src/core/types.hpp"
+#include "src/core/distribution.hpp"
+
+namespace ucsb {
+
+/**
+ * @brief The longest encoded key, including the prefix.
+ */
+constexpr size_t key_max_length_k = 256;
+/**
+ * @brief Hex digits of the integer in `string` keys.
+ */
+constexpr size_t key_digits_count_k = 16;
+
+enum class key_format_t {
+    unknown_k,
+
+    fixed_k,      // 8 bytes of the integer, as they are in memory
+    big_endian_k, // The prefix, followed by 8 big-endian bytes of the integer
+    string_k,     // The prefix, 16 hex digits of the integer and a filler up to the key length
+};
+
+/**
+ * @brief How integer keys, generated by the benchmark, are stored in the DB.
+ * Both `big_endian` and `string` keys are ordered the same way as integers
+ * by a plain byte-wise comparison, so range queries stay meaningful.
+ */
+struct key_encoding_t {
+    key_format_t format = key_format_t::fixed_k;
+    std::string prefix;
+    /**
+     * @brief Lengths of `string` keys, including the prefix. Keys are never shorter,
+     * than the prefix and 16 digits. Every key always gets the same length.
+     * Lengths are either `uniform` in the range or `const` at the longest.
+     */
+    size_t min_length = 0;
+    size_t max_length = 0;
+    distribution_kind_t length_dist = distribution_kind_t::uniform_k;
+
+    inline bool is_fixed() const noexcept { return format == key_format_t::fixed_k; }
+    /**
+     * @brief Whether the longest key fits into `key_max_length_k` bytes.
+     */
+    inline bool is_valid() const noexcept {
+        return prefix.size() + key_digits_count_k <= key_max_length_k && max_length <= key_max_length_k &&
+               min_length <= max_length;
+    }
+    inline bool operator==(key_encoding_t const&) const = default;
+};
+
+/**
+ * @brief Encodes integer keys into bytes, without heap allocations.
+ */
+class key_encoder_t {
+  public:
+    static constexpr size_t digits_count_k = key_digits_count_k;
+
+    inline key_encoder_t() : key_encoder_t(key_encoding_t {}) {}
+    inline key_encoder_t(key_encoding_t const& encoding) : encoding_(encoding) {
+        // Note: Keys are encoded into fixed buffers, so whatever the encoding is, they never outgrow them
+        if (encoding_.prefix.size() > key_max_length_k - digits_count_k)
+            encoding_.prefix.resize(key_max_length_k - digits_count_k);
+        size_t min_length = encoding_.prefix.size() + digits_count_k;
+        encoding_.min_length = std::clamp(encoding_.min_length, min_length, key_max_length_k);
+        encoding_.max_length = std::clamp(encoding_.max_length, encoding_.min_length, key_max_length_k);
+        if (encoding_.length_dist == distribution_kind_t::const_k)
+            encoding_.min_length = encoding_.max_length;
+    }
+
+    inline key_encoding_t const& encoding() const noexcept { return encoding_; }
+    inline bool is_fixed() const noexcept { return encoding_.is_fixed(); }
+
+    /**
+     * @return The length of the key written into the `output` of `key_max_length_k` bytes.
+     */
+    inline size_t encode(key_t key, char* output) const noexcept {
+        switch (encoding_.format) {
+        case key_format_t::big_endian_k: {
+            std::memcpy(output, encoding_.prefix.data(), encoding_.prefix.size());
+            key_t big_endian = __builtin_bswap64(key);
+            std::memcpy(output + encoding_.prefix.size(), &big_endian, sizeof(key_t));
+            return encoding_.prefix.size() + sizeof(key_t);
+        }
+        case key_format_t::string_k: return encode_string(key, output);
+        default: std::memcpy(output, &key, sizeof(key_t)); return sizeof(key_t);
+        }
+    }
+
+  private:
+    static_assert(sizeof(key_t) == sizeof(uint64_t), "Check `__builtin_bswap64`");
+
+    inline size_t encode_string(key_t key, char* output) const noexcept {
+        constexpr char digits_k[] = "0123456789abcdef";
+        char* digits = output + encoding_.prefix.size();
+        std::memcpy(output, encoding_.prefix.data(), encoding_.prefix.size());
+        for (size_t i = 0; i != digits_count_k; ++i)
+            digits[i] = digits_k[(key >> ((digits_count_k - 1 - i) * 4)) & 0xF];
+
+        // Note: The length and the filler depend on the key only, so the key is the same on every access
+        uint64_t hash = (key ^ (key >> 31)) * 0x9E3779B97F4A7C15ull;
+        size_t length = encoding_.min_length + hash % (encoding_.max_length - encoding_.min_length + 1);
+        for (size_t i = encoding_.prefix.size() + digits_count_k; i != length; ++i) {
+            hash = hash * 6364136223846793005ull + 1442695040888963407ull;
+            output[i] = char('a' + (hash >> 59) % 26);
+        }
+        return length;
+    }
+
+    key_encoding_t encoding_;
+};
+
+/**
+ * @brief A single encoded key, which can be kept on the stack or in preallocated buffers.
+ */
+class encoded_key_t {
+  public:
+    inline encoded_key_t() noexcept : length_(0) {}
+    inline encoded_key_t(key_t key, key_encoder_t const& encoder) noexcept : length_(encoder.encode(key, data_)) {}
+
+    inline char const* data() const noexcept { return data_; }
+    inline size_t size() const noexcept { return length_; }
+    inline std::string_view view() const noexcept { return {data_, length_}; }
+
+  private:
+    char data_[key_max_length_k];
+    size_t length_;
+};
+
+inline key_format_t parse_key_format(std::string const& name) {
+    key_format_t format = key_format_t::unknown_k;
+    if (name == "fixed")
+        format = key_format_t::fixed_k;
+    else if (name == "big_endian")
+        format = key_format_t::big_endian_k;
+    else if (name == "string")
+        format = key_format_t::string_k;
+    return format;
+}
+
+} // namespace ucsb
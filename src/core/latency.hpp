@@ -0,0 +1,170 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#include "src/core/types.hpp"
+#include "src/core/helper.hpp"
+#include "src/core/timer.hpp"
+#include "src/core/operation.hpp"
+
+namespace ucsb {
+
+/**
+ * @brief Summary of a latency distribution, all values are in nanoseconds.
+ */
+struct latency_percentiles_t {
+    size_t count = 0;
+    size_t p50 = 0;
+    size_t p90 = 0;
+    size_t p99 = 0;
+    size_t p99_9 = 0;
+    size_t max = 0;
+};
+
+/**
+ * @brief HDR-style histogram of latencies in nanoseconds.
+ * Values are grouped into log-linear buckets: every power of two is split into
+ * `2^(significant_bits_k - 1)` equal sub-buckets, so the relative error of any
+ * reported percentile is below `2^-(significant_bits_k - 1)` (~1.6%).
+ *
+ * A histogram has a single writer (the owning thread), but can be read
+ * concurrently by monitoring threads, so counters are accessed atomically.
+ */
+class latency_histogram_t {
+  public:
+    static constexpr size_t significant_bits_k = 7;
+    static constexpr size_t sub_buckets_count_k = size_t(1) << (significant_bits_k - 1);
+    // Covers latencies up to ~18 minutes, longer ones are clamped
+    static constexpr size_t max_value_bits_k = 40;
+    static constexpr size_t max_value_k = (size_t(1) << max_value_bits_k) - 1;
+    static constexpr size_t buckets_count_k = (max_value_bits_k - significant_bits_k + 2) * sub_buckets_count_k;
+
+    inline latency_histogram_t() : buckets_(buckets_count_k, 0), count_(0), max_(0) {}
+
+    inline void record(size_t nanoseconds) noexcept {
+        nanoseconds = std::min(nanoseconds, max_value_k);
+        size_t& bucket = buckets_[bucket_index(nanoseconds)];
+        atomic_store(bucket, bucket + 1);
+        atomic_store(count_, count_ + 1);
+        if (nanoseconds > max_)
+            atomic_store(max_, nanoseconds);
+    }
+
+    inline void merge(latency_histogram_t& other) noexcept {
+        for (size_t idx = 0; idx != buckets_count_k; ++idx)
+            buckets_[idx] += atomic_load(other.buckets_[idx]);
+        count_ += atomic_load(other.count_);
+        max_ = std::max(max_, atomic_load(other.max_));
+    }
+
+    /**
+     * @brief Removes the values of an older snapshot of the same histogram,
+     * leaving only the ones recorded since then. The maximum is approximated
+     * by the highest non-empty bucket.
+     */
+    inline void subtract(latency_histogram_t const& older) noexcept {
+        size_t highest_idx = 0;
+        for (size_t idx = 0; idx != buckets_count_k; ++idx) {
+            buckets_[idx] -= older.buckets_[idx];
+            if (buckets_[idx])
+                highest_idx = idx;
+        }
+        count_ -= older.count_;
+        max_ = count_ ? std::min(bucket_highest_value(highest_idx), max_) : 0;
+    }
+
+    inline void clear() noexcept {
+        std::fill(buckets_.begin(), buckets_.end(), 0);
+        count_ = 0;
+        max_ = 0;
+    }
+
+    inline size_t count() const noexcept { return count_; }
+    inline size_t max() const noexcept { return max_; }
+
+    /**
+     * @brief Returns the highest latency equivalent to the bucket,
+     * which contains the requested quantile (in range [0, 1]).
+     */
+    inline size_t percentile(double quantile) const noexcept {
+        if (!count_)
+            return 0;
+
+        size_t rank = std::max(size_t(1), size_t(quantile * count_ + 0.5));
+        size_t cumulative = 0;
+        for (size_t idx = 0; idx != buckets_count_k; ++idx) {
+            cumulative += buckets_[idx];
+            if (cumulative >= rank)
+                return std::min(bucket_highest_value(idx), max_);
+        }
+        return max_;
+    }
+
+    inline latency_percentiles_t percentiles() const noexcept {
+        latency_percentiles_t result;
+        result.count = count_;
+        result.p50 = percentile(0.5);
+        result.p90 = percentile(0.9);
+        result.p99 = percentile(0.99);
+        result.p99_9 = percentile(0.999);
+        result.max = max_;
+        return result;
+    }
+
+  private:
+    static inline size_t bucket_index(size_t value) noexcept {
+        size_t msb = 63 - __builtin_clzll(value | 1);
+        size_t shift = msb < significant_bits_k ? 0 : msb - significant_bits_k + 1;
+        return (shift * sub_buckets_count_k) + (value >> shift);
+    }
+
+    static inline size_t bucket_highest_value(size_t idx) noexcept {
+        if (idx < 2 * sub_buckets_count_k)
+            return idx;
+        size_t shift = idx / sub_buckets_count_k - 1;
+        size_t mantissa = idx - shift * sub_buckets_count_k;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    std::vector<size_t> buckets_;
+    size_t count_;
+    size_t max_;
+};
+
+/**
+ * @brief Latency histograms of a single thread, one per operation kind.
+ */
+class operation_latencies_t {
+  public:
+    inline void record(operation_kind_t kind, elapsed_time_t elapsed_time) noexcept {
+        histograms_[size_t(kind)].record(std::max(elapsed_time.count(), int64_t(0)));
+    }
+
+    inline void merge(operation_latencies_t& other) noexcept {
+        for (size_t idx = 0; idx != operation_kinds_count_k; ++idx)
+            histograms_[idx].merge(other.histograms_[idx]);
+    }
+
+    inline void subtract(operation_latencies_t const& older) noexcept {
+        for (size_t idx = 0; idx != operation_kinds_count_k; ++idx)
+            histograms_[idx].subtract(older.histograms_[idx]);
+    }
+
+    inline void clear() noexcept {
+        for (auto& histogram : histograms_)
+            histogram.clear();
+    }
+
+    inline latency_histogram_t& operator[](operation_kind_t kind) noexcept { return histograms_[size_t(kind)]; }
+    inline latency_histogram_t const& operator[](operation_kind_t kind) const noexcept {
+        return histograms_[size_t(kind)];
+    }
+
+  private:
+    std::array<latency_histogram_t, operation_kinds_count_k> histograms_;
+};
+
+} // namespace ucsb
@@ -1,11 +1,11 @@
 #pragma once
 
-#include <vector>
-#include <random>
+#include <array>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 
-#include "src/core/generators/random_generator.hpp"
+#include "src/core/generators/random_engine.hpp"
 
 namespace ucsb {
 
@@ -20,8 +20,44 @@ enum class operation_kind_t {
     bulk_load_k,
     range_select_k,
     scan_k,
+    // Note: Never chosen by weight, ends every transaction of the configured length
+    commit_k,
 };
 
+constexpr size_t operation_kinds_count_k = size_t(operation_kind_t::commit_k) + 1;
+
+inline char const* operation_kind_name(operation_kind_t kind) {
+    switch (kind) {
+    case operation_kind_t::upsert_k: return "upsert";
+    case operation_kind_t::update_k: return "update";
+    case operation_kind_t::remove_k: return "remove";
+    case operation_kind_t::read_k: return "read";
+    case operation_kind_t::read_modify_write_k: return "read_modify_write";
+    case operation_kind_t::batch_upsert_k: return "batch_upsert";
+    case operation_kind_t::batch_read_k: return "batch_read";
+    case operation_kind_t::bulk_load_k: return "bulk_load";
+    case operation_kind_t::range_select_k: return "range_select";
+    case operation_kind_t::scan_k: return "scan";
+    case operation_kind_t::commit_k: return "commit";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Whether the operation modifies the DB, so its bytes count as logically written.
+ */
+inline bool is_write_operation(operation_kind_t kind) {
+    switch (kind) {
+    case operation_kind_t::upsert_k:
+    case operation_kind_t::update_k:
+    case operation_kind_t::remove_k:
+    case operation_kind_t::read_modify_write_k:
+    case operation_kind_t::batch_upsert_k:
+    case operation_kind_t::bulk_load_k: return true;
+    default: return false;
+    }
+}
+
 enum class operation_status_t : int {
     ok_k = 1,
     error_k = -1,
@@ -42,35 +78,86 @@ struct operation_result_t {
     operation_status_t status = operation_status_t::ok_k;
 };
 
+/**
+ * @brief Picks operations by their weights in O(1), using Walker's alias method.
+ * Only operations with non-zero weights get slots, and every choice takes a single
+ * draw of the random engine: the upper half selects the slot, the lower half
+ * selects between the slot operation and its alias.
+ */
 class operation_chooser_t {
   public:
-    inline operation_chooser_t() : generator_(0.0, 1.0), sum_(0) {}
+    inline operation_chooser_t() : count_(0), sum_(0) {}
 
     inline void add(operation_kind_t op, float weight);
-    inline operation_kind_t choose();
+    inline void seed(core::random_engine_t& streams) { engine_ = streams.split(); }
+    inline operation_kind_t choose() noexcept;
+
+    /**
+     * @brief Whether only a single operation is ever chosen, so the choice can be skipped.
+     */
+    inline bool is_single() const noexcept { return count_ == 1; }
+    inline operation_kind_t single() const noexcept { return ops_[0]; }
 
   private:
-    std::vector<std::pair<operation_kind_t, float>> ops_;
-    core::random_double_generator_t generator_;
+    inline void build();
+
+    std::array<float, operation_kinds_count_k> weights_ {};
+    std::array<operation_kind_t, operation_kinds_count_k> ops_ {};
+    std::array<operation_kind_t, operation_kinds_count_k> aliases_ {};
+    std::array<uint64_t, operation_kinds_count_k> thresholds_ {};
+    size_t count_;
     float sum_;
+    core::random_engine_t engine_;
 };
 
 inline void operation_chooser_t::add(operation_kind_t op, float weight) {
-    ops_.push_back(std::make_pair(op, weight));
+    if (weight <= 0)
+        return;
+    assert(count_ < operation_kinds_count_k);
+    ops_[count_] = op;
+    weights_[count_] = weight;
+    ++count_;
     sum_ += weight;
+    build();
 }
 
-inline operation_kind_t operation_chooser_t::choose() {
-    float chooser = generator_.generate();
-    for (auto op = ops_.cbegin(); op != ops_.cend(); ++op) {
-        float part = op->second / sum_;
-        if (chooser < part)
-            return op->first;
-        chooser -= part;
-    }
+inline operation_kind_t operation_chooser_t::choose() noexcept {
+    assert(count_ > 0);
+    uint64_t random = engine_();
+    size_t idx = ((random >> 32) * count_) >> 32;
+    return (random & UINT32_MAX) < thresholds_[idx] ? ops_[idx] : aliases_[idx];
+}
 
-    assert(false);
-    return operation_kind_t::read_k;
+inline void operation_chooser_t::build() {
+    // Note: Vose's variant, scaled probabilities below 1 are topped up by the aliases of the larger ones
+    std::array<double, operation_kinds_count_k> scaled {};
+    std::array<size_t, operation_kinds_count_k> small {};
+    std::array<size_t, operation_kinds_count_k> large {};
+    size_t small_count = 0, large_count = 0;
+    for (size_t idx = 0; idx != count_; ++idx) {
+        scaled[idx] = double(weights_[idx]) * count_ / sum_;
+        aliases_[idx] = ops_[idx];
+        if (scaled[idx] < 1.0)
+            small[small_count++] = idx;
+        else
+            large[large_count++] = idx;
+    }
+    while (small_count && large_count) {
+        size_t less = small[--small_count];
+        size_t more = large[large_count - 1];
+        aliases_[less] = ops_[more];
+        thresholds_[less] = uint64_t(scaled[less] * (uint64_t(1) << 32));
+        scaled[more] -= 1.0 - scaled[less];
+        if (scaled[more] < 1.0) {
+            --large_count;
+            small[small_count++] = more;
+        }
+    }
+    // Note: Leftovers are only off from 1 by rounding errors
+    for (size_t idx = 0; idx != large_count; ++idx)
+        thresholds_[large[idx]] = uint64_t(1) << 32;
+    for (size_t idx = 0; idx != small_count; ++idx)
+        thresholds_[small[idx]] = uint64_t(1) << 32;
 }
 
 } // namespace ucsb
\ No newline at end of file
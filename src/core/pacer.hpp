@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <thread>
+
+#include "src/core/timer.hpp"
+
+namespace ucsb {
+
+/**
+ * @brief Schedules operations of a single thread on an intended-start timeline.
+ *
+ * In closed-loop mode (zero rate) the next operation starts right away.
+ * In open-loop mode operations are issued at a fixed rate regardless of how
+ * long previous ones took. Latencies are measured from the intended start,
+ * so a stalled DB can't hide its latency spike by slowing down the load
+ * generator, also known as "coordinated omission".
+ */
+class pacer_t {
+  public:
+    inline pacer_t(double operations_per_second)
+        : interval_(operations_per_second > 0 ? 1e9 / operations_per_second : 0), scheduled_count_(0) {}
+
+    inline bool is_open_loop() const noexcept { return interval_ > 0; }
+
+    inline void start() {
+        start_time_ = bench_clock_t::now();
+        scheduled_count_ = 0;
+    }
+
+    /**
+     * @brief Waits for the intended start of the next operation and returns it.
+     * If the thread is already behind the schedule, returns immediately.
+     */
+    inline time_point_t next() {
+        if (!is_open_loop())
+            return bench_clock_t::now();
+
+        auto offset = std::chrono::nanoseconds(size_t(interval_ * scheduled_count_));
+        ++scheduled_count_;
+        return at(offset);
+    }
+
+    /**
+     * @brief Waits for the given offset since the start and returns it.
+     * Used to replay timestamped traces, regardless of the target rate.
+     */
+    inline time_point_t at(elapsed_time_t offset) {
+        time_point_t intended_start_time = start_time_ + offset;
+
+        // Note: Sleeping is too coarse for short delays, so the rest is spun
+        auto now = bench_clock_t::now();
+        if (intended_start_time - now > sleep_threshold_k)
+            std::this_thread::sleep_for(intended_start_time - now - sleep_threshold_k);
+        while (bench_clock_t::now() < intended_start_time)
+            std::this_thread::yield();
+
+        return intended_start_time;
+    }
+
+  private:
+    static constexpr std::chrono::microseconds sleep_threshold_k {100};
+
+    double interval_; // In nanoseconds
+    time_point_t start_time_;
+    size_t scheduled_count_;
+};
+
+} // namespace ucsb
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <string>
+#include <chrono>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include "src/core/timer.hpp"
+#include "src/core/operation.hpp"
+#include "src/core/latency.hpp"
+#include "src/core/progress.hpp"
+
+namespace ucsb {
+
+/**
+ * @brief Cumulative counters of all threads at a phase boundary.
+ */
+struct phase_snapshot_t {
+    time_point_t time;
+    progress_t::counters_t counters;
+    operation_latencies_t latencies;
+};
+
+using phase_snapshots_t = std::vector<phase_snapshot_t>;
+
+/**
+ * @brief Must be taken while all threads wait on a fence, so the counters are consistent.
+ */
+inline phase_snapshot_t take_phase_snapshot(progress_t const& progress,
+                                            std::vector<operation_latencies_t>& threads_latencies) {
+    phase_snapshot_t snapshot;
+    snapshot.time = bench_clock_t::now();
+    snapshot.counters = progress.counters();
+    for (auto& thread_latencies : threads_latencies)
+        snapshot.latencies.merge(thread_latencies);
+    return snapshot;
+}
+
+/**
+ * @brief Stats of a single phase of a workload.
+ */
+struct phase_stats_t {
+    std::string name;
+    double start = 0; // In seconds since the start of the workload
+    double duration = 0;
+    size_t operations_count = 0;
+    double operations_per_second = 0;
+    double fails_percent = 0;
+    std::array<latency_percentiles_t, operation_kinds_count_k> latencies;
+};
+
+using phases_stats_t = std::vector<phase_stats_t>;
+
+/**
+ * @brief Stats of the phase between two consecutive snapshots.
+ */
+inline phase_stats_t make_phase_stats(std::string const& name,
+                                      phase_snapshot_t const& first,
+                                      phase_snapshot_t const& last,
+                                      phase_snapshot_t const& current) {
+    phase_stats_t stats;
+    stats.name = name;
+    stats.start = std::chrono::duration<double>(last.time - first.time).count();
+    stats.duration = std::chrono::duration<double>(current.time - last.time).count();
+
+    size_t entries_touched = current.counters.entries_touched - last.counters.entries_touched;
+    size_t done_iterations = current.counters.done_iterations - last.counters.done_iterations;
+    size_t failed_iterations = current.counters.failed_iterations - last.counters.failed_iterations;
+    stats.operations_count = done_iterations;
+    stats.operations_per_second = stats.duration > 0 ? entries_touched / stats.duration : 0;
+    stats.fails_percent = done_iterations ? failed_iterations * 100.0 / done_iterations : 0;
+
+    operation_latencies_t phase_latencies = current.latencies;
+    phase_latencies.subtract(last.latencies);
+    for (size_t kind_idx = 0; kind_idx != operation_kinds_count_k; ++kind_idx)
+        stats.latencies[kind_idx] = phase_latencies[operation_kind_t(kind_idx)].percentiles();
+
+    return stats;
+}
+
+/**
+ * @brief Converts the phases stats into a JSON array, using the same naming
+ * for the stats as the final benchmark counters.
+ */
+inline nlohmann::ordered_json phases_to_json(phases_stats_t const& phases) {
+    nlohmann::ordered_json j_phases = nlohmann::ordered_json::array();
+    for (auto const& phase : phases) {
+        nlohmann::ordered_json j_phase;
+        j_phase["name"] = phase.name;
+        j_phase["start,s"] = phase.start;
+        j_phase["duration,s"] = phase.duration;
+        j_phase["operations"] = phase.operations_count;
+        j_phase["operations/s"] = phase.operations_per_second;
+        j_phase["fails,%"] = phase.fails_percent;
+        for (size_t kind_idx = 0; kind_idx != operation_kinds_count_k; ++kind_idx) {
+            auto const& percentiles = phase.latencies[kind_idx];
+            if (!percentiles.count)
+                continue;
+            auto kind_name = operation_kind_name(operation_kind_t(kind_idx));
+            j_phase[fmt::format("lat_p50({}),us", kind_name)] = percentiles.p50 / 1'000.0;
+            j_phase[fmt::format("lat_p90({}),us", kind_name)] = percentiles.p90 / 1'000.0;
+            j_phase[fmt::format("lat_p99({}),us", kind_name)] = percentiles.p99 / 1'000.0;
+            j_phase[fmt::format("lat_p99.9({}),us", kind_name)] = percentiles.p99_9 / 1'000.0;
+            j_phase[fmt::format("lat_max({}),us", kind_name)] = percentiles.max / 1'000.0;
+        }
+        j_phases.push_back(j_phase);
+    }
+    return j_phases;
+}
+
+} // namespace ucsb
@@ -19,6 +19,10 @@ struct printable_duration_t {
     size_t duration = 0; // In milliseconds
 };
 
+struct printable_latency_t {
+    double latency = 0; // In microseconds
+};
+
 } // namespace ucsb
 
 template <>
@@ -204,4 +208,25 @@ class fmt::formatter<ucsb::printable_duration_t> {
 
         return fmt::format_to(ctx.out(), "{}", str_duration);
     }
+};
+template <>
+class fmt::formatter<ucsb::printable_latency_t> {
+  public:
+    template <typename ctx_at>
+    constexpr auto parse(ctx_at& ctx) {
+        return ctx.begin();
+    }
+
+    template <typename ctx_at>
+    auto format(ucsb::printable_latency_t const& v, ctx_at& ctx) {
+
+        double latency = v.latency;
+        if (latency < 1.0)
+            return fmt::format_to(ctx.out(), "{:.0f}ns", latency * 1'000.0);
+        if (latency < 1'000.0)
+            return fmt::format_to(ctx.out(), "{:.2f}us", latency);
+        if (latency < 1'000'000.0)
+            return fmt::format_to(ctx.out(), "{:.2f}ms", latency / 1'000.0);
+        return fmt::format_to(ctx.out(), "{:.2f}s", latency / 1'000'000.0);
+    }
 };
\ No newline at end of file
@@ -1,14 +1,27 @@
 #pragma once
 
 #include <sys/times.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <linux/perf_event.h>
 #include <unistd.h>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 #include <string>
+#include <vector>
 #include <fstream>
+#include <algorithm>
 #include <limits>
 #include <chrono>
 #include <thread>
 #include <atomic>
 
+#include "src/core/types.hpp"
+
 namespace ucsb {
 
 /**
@@ -197,4 +210,315 @@ class mem_profiler_t {
     size_t page_size_;
 };
 
-} // namespace ucsb
\ No newline at end of file
+/**
+ * @brief Manages a sibling thread, that samples the storage I/O accounting
+ * of the current process from "/proc/self/io" and of the devices behind
+ * the DB directories from "/proc/diskstats".
+ * Process counters include the background threads of the DB, like compactions.
+ * Device counters include everything on the device, but unlike the process
+ * counters they also see the writeback of the page cache and the journal.
+ *
+ * @see proc: https://man7.org/linux/man-pages/man5/proc.5.html
+ * @see diskstats: https://www.kernel.org/doc/Documentation/ABI/testing/procfs-diskstats
+ */
+class io_profiler_t {
+  public:
+    inline io_profiler_t(std::vector<fs::path> const& dir_paths, size_t request_delay = 100)
+        : time_to_die_(true), request_delay_(request_delay) {
+        for (auto const& dir_path : dir_paths) {
+            struct stat dir_stat;
+            if (stat(dir_path.c_str(), &dir_stat) != 0)
+                continue;
+            device_t device {major(dir_stat.st_dev), minor(dir_stat.st_dev)};
+            if (std::find(devices_.begin(), devices_.end(), device) == devices_.end())
+                devices_.push_back(device);
+        }
+    }
+    ~io_profiler_t() { stop(); }
+
+    struct stats_t {
+        // Process
+        size_t read_bytes = 0;
+        size_t write_bytes = 0;
+        size_t read_syscalls = 0;
+        size_t write_syscalls = 0;
+        // Devices
+        bool has_devices = false;
+        size_t device_read_bytes = 0;
+        size_t device_write_bytes = 0;
+        size_t device_max_read_bytes_per_second = 0;
+        size_t device_max_write_bytes_per_second = 0;
+    };
+
+    inline void start() {
+        if (!time_to_die_.load())
+            return;
+
+        stats_ = stats_t {};
+        first_sample_ = sample();
+        time_to_die_.store(false);
+        thread_ = std::thread(&io_profiler_t::request_io_usage, this);
+    }
+    inline void stop() {
+        if (time_to_die_.load())
+            return;
+
+        time_to_die_.store(true);
+        thread_.join();
+        recalculate(sample());
+    }
+
+    inline stats_t stats() const { return stats_; }
+
+  private:
+    struct device_t {
+        unsigned major = 0;
+        unsigned minor = 0;
+        inline bool operator==(device_t const& other) const noexcept {
+            return major == other.major && minor == other.minor;
+        }
+    };
+
+    struct sample_t {
+        std::chrono::steady_clock::time_point time;
+        size_t read_bytes = 0;
+        size_t write_bytes = 0;
+        size_t read_syscalls = 0;
+        size_t write_syscalls = 0;
+        size_t device_read_bytes = 0;
+        size_t device_write_bytes = 0;
+        bool has_devices = false;
+    };
+
+    inline void recalculate(sample_t const& current) {
+        stats_.read_bytes = current.read_bytes - first_sample_.read_bytes;
+        stats_.write_bytes = current.write_bytes - first_sample_.write_bytes;
+        stats_.read_syscalls = current.read_syscalls - first_sample_.read_syscalls;
+        stats_.write_syscalls = current.write_syscalls - first_sample_.write_syscalls;
+        stats_.has_devices = current.has_devices && first_sample_.has_devices;
+        stats_.device_read_bytes = current.device_read_bytes - first_sample_.device_read_bytes;
+        stats_.device_write_bytes = current.device_write_bytes - first_sample_.device_write_bytes;
+    }
+
+    void request_io_usage() {
+        sample_t last = first_sample_;
+        while (!time_to_die_.load(std::memory_order_relaxed)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(request_delay_));
+
+            sample_t current = sample();
+            double interval = std::chrono::duration<double>(current.time - last.time).count();
+            if (interval > 0) {
+                size_t read_rate = (current.device_read_bytes - last.device_read_bytes) / interval;
+                size_t write_rate = (current.device_write_bytes - last.device_write_bytes) / interval;
+                stats_.device_max_read_bytes_per_second = std::max(read_rate, stats_.device_max_read_bytes_per_second);
+                stats_.device_max_write_bytes_per_second =
+                    std::max(write_rate, stats_.device_max_write_bytes_per_second);
+            }
+            recalculate(current);
+            last = current;
+        }
+    }
+
+    inline sample_t sample() const {
+        sample_t sample;
+        sample.time = std::chrono::steady_clock::now();
+
+        std::ifstream io("/proc/self/io", std::ios_base::in);
+        std::string name;
+        size_t value = 0;
+        while (io >> name >> value) {
+            if (name == "syscr:")
+                sample.read_syscalls = value;
+            else if (name == "syscw:")
+                sample.write_syscalls = value;
+            else if (name == "read_bytes:")
+                sample.read_bytes = value;
+            else if (name == "write_bytes:")
+                sample.write_bytes = value;
+        }
+
+        // Note: Sectors in "/proc/diskstats" are always 512 bytes, regardless of the device
+        std::ifstream diskstats("/proc/diskstats", std::ios_base::in);
+        std::string line;
+        while (std::getline(diskstats, line)) {
+            device_t device;
+            char device_name[64];
+            size_t reads = 0, reads_merged = 0, sectors_read = 0, read_time = 0;
+            size_t writes = 0, writes_merged = 0, sectors_written = 0;
+            int parsed = sscanf(line.c_str(),
+                                "%u %u %63s %zu %zu %zu %zu %zu %zu %zu",
+                                &device.major,
+                                &device.minor,
+                                device_name,
+                                &reads,
+                                &reads_merged,
+                                &sectors_read,
+                                &read_time,
+                                &writes,
+                                &writes_merged,
+                                &sectors_written);
+            if (parsed != 10 || std::find(devices_.begin(), devices_.end(), device) == devices_.end())
+                continue;
+            sample.has_devices = true;
+            sample.device_read_bytes += sectors_read * 512;
+            sample.device_write_bytes += sectors_written * 512;
+        }
+
+        return sample;
+    }
+
+    std::thread thread_;
+    std::atomic_bool time_to_die_;
+
+    std::vector<device_t> devices_;
+    sample_t first_sample_;
+    stats_t stats_;
+    size_t request_delay_;
+};
+
+/**
+ * @brief Hardware performance counters of a single thread.
+ * Unavailable counters are zero and aren't marked in the `available` mask.
+ */
+struct hw_counters_t {
+    enum event_t {
+        cycles_k = 0,
+        instructions_k,
+        llc_loads_k,
+        llc_misses_k,
+        dtlb_misses_k,
+        branch_misses_k,
+        context_switches_k,
+
+        events_count_k,
+    };
+
+    std::array<size_t, events_count_k> values {};
+    size_t available = 0;
+
+    inline bool has(event_t event) const noexcept { return available & (size_t(1) << event); }
+    inline size_t operator[](event_t event) const noexcept { return values[event]; }
+
+    inline hw_counters_t& operator+=(hw_counters_t const& other) noexcept {
+        for (size_t idx = 0; idx != events_count_k; ++idx)
+            values[idx] += other.values[idx];
+        available &= other.available;
+        return *this;
+    }
+};
+
+/**
+ * @brief Counts hardware events of the calling thread with `perf_event_open`,
+ * so every benchmark thread owns one and the results are summed afterwards.
+ * Unlike the sampling profilers above it has no sibling thread, the kernel
+ * does the counting. If `perf_event_paranoid` forbids kernel-side counting,
+ * only user-space is counted; if it forbids everything, counters are unavailable.
+ *
+ * @see perf_event_open: https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+ */
+class hw_profiler_t {
+  public:
+    inline hw_profiler_t() { fds_.fill(-1); }
+    ~hw_profiler_t() { close(); }
+
+    hw_profiler_t(hw_profiler_t const&) = delete;
+    hw_profiler_t& operator=(hw_profiler_t const&) = delete;
+
+    /**
+     * @brief Checks whether at least the cycles counter can be opened in this environment.
+     */
+    static bool is_available() {
+        int fd = open_event(hw_counters_t::cycles_k);
+        if (fd < 0)
+            return false;
+        ::close(fd);
+        return true;
+    }
+
+    inline void start() {
+        for (size_t idx = 0; idx != hw_counters_t::events_count_k; ++idx)
+            fds_[idx] = open_event(hw_counters_t::event_t(idx));
+        for (int fd : fds_) {
+            if (fd < 0)
+                continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+    inline void stop() {
+        for (int fd : fds_)
+            if (fd >= 0)
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+        counters_ = hw_counters_t {};
+        for (size_t idx = 0; idx != hw_counters_t::events_count_k; ++idx) {
+            if (fds_[idx] < 0)
+                continue;
+            // Note: If the PMU is oversubscribed, the kernel multiplexes events, so the value is scaled
+            uint64_t value[3] = {0, 0, 0}; // Value, time enabled, time running
+            if (read(fds_[idx], value, sizeof(value)) != sizeof(value) || !value[2])
+                continue;
+            counters_.values[idx] = value[2] == value[1] ? value[0] : size_t(double(value[0]) * value[1] / value[2]);
+            counters_.available |= size_t(1) << idx;
+        }
+        close();
+    }
+
+    inline hw_counters_t const& counters() const noexcept { return counters_; }
+
+  private:
+    static int open_event(hw_counters_t::event_t event) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.disabled = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        switch (event) {
+        case hw_counters_t::cycles_k: set(attr, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES); break;
+        case hw_counters_t::instructions_k: set(attr, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS); break;
+        case hw_counters_t::llc_loads_k: set(attr, PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_LL)); break;
+        case hw_counters_t::llc_misses_k:
+            set(attr, PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_MISS));
+            break;
+        case hw_counters_t::dtlb_misses_k:
+            set(attr, PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_RESULT_MISS));
+            break;
+        case hw_counters_t::branch_misses_k: set(attr, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES); break;
+        case hw_counters_t::context_switches_k: set(attr, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES); break;
+        default: return -1;
+        }
+
+        // Note: Calling thread on any CPU
+        int fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd < 0 && (errno == EACCES || errno == EPERM)) {
+            attr.exclude_kernel = 1;
+            fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        }
+        return fd;
+    }
+
+    static inline void set(perf_event_attr& attr, uint32_t type, uint64_t config) noexcept {
+        attr.type = type;
+        attr.config = config;
+    }
+
+    static inline uint64_t cache_event(uint64_t cache,
+                                       uint64_t result = PERF_COUNT_HW_CACHE_RESULT_ACCESS) noexcept {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+    }
+
+    inline void close() {
+        for (int& fd : fds_) {
+            if (fd >= 0)
+                ::close(fd);
+            fd = -1;
+        }
+    }
+
+    std::array<int, hw_counters_t::events_count_k> fds_;
+    hw_counters_t counters_;
+};
+
+} // namespace ucsb
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <fmt/format.h>
+#include <fmt/color.h>
+
+#include "src/core/timer.hpp"
+#include "src/core/helper.hpp"
+#include "src/core/printable.hpp"
+#include "src/core/operation.hpp"
+
+namespace ucsb {
+
+/**
+ * @brief Operation counters of a single thread.
+ * Every slot occupies its own cache line and has a single writer,
+ * so the benchmark loop never contends with other threads.
+ */
+struct alignas(64) progress_slot_t {
+    size_t entries_touched = 0;
+    size_t bytes_processed = 0;
+    size_t bytes_written = 0;
+    size_t done_iterations = 0;
+    size_t failed_iterations = 0;
+    size_t total_iterations = 0;
+
+    inline void add(operation_result_t const& result, size_t bytes_processed, bool is_write = false) noexcept {
+        bool success = result.status == operation_status_t::ok_k;
+        atomic_store(this->entries_touched, this->entries_touched + size_t(success) * result.entries_touched);
+        atomic_store(this->bytes_processed, this->bytes_processed + size_t(success) * bytes_processed);
+        atomic_store(this->bytes_written, this->bytes_written + size_t(success && is_write) * bytes_processed);
+        atomic_store(this->failed_iterations, this->failed_iterations + size_t(!success));
+        atomic_store(this->done_iterations, this->done_iterations + 1);
+    }
+
+    inline void clear() noexcept { *this = progress_slot_t {}; }
+};
+
+/**
+ * @brief Aggregates the per-thread progress slots.
+ * Manages a sibling thread, which periodically prints the progress line,
+ * so the benchmark threads never print themselves.
+ */
+class progress_t {
+  public:
+    using counters_t = progress_slot_t;
+
+    inline progress_t(size_t threads_count, size_t request_delay = 250)
+        : slots_(threads_count), time_to_die_(true), request_delay_(request_delay), prev_ops_per_second_(0) {}
+    ~progress_t() { stop(); }
+
+    inline progress_slot_t& slot(size_t thread_idx) noexcept { return slots_[thread_idx]; }
+
+    inline counters_t counters() const noexcept {
+        counters_t counters;
+        for (auto const& slot : slots_) {
+            counters.entries_touched += atomic_load(slot.entries_touched);
+            counters.bytes_processed += atomic_load(slot.bytes_processed);
+            counters.bytes_written += atomic_load(slot.bytes_written);
+            counters.done_iterations += atomic_load(slot.done_iterations);
+            counters.failed_iterations += atomic_load(slot.failed_iterations);
+            counters.total_iterations += atomic_load(slot.total_iterations);
+        }
+        return counters;
+    }
+
+    /**
+     * @param duration If set, in seconds, the progress is measured in time instead of iterations.
+     */
+    inline void start(std::string const& workload_name, double duration = 0) {
+        if (!time_to_die_)
+            return;
+
+        workload_name_ = workload_name;
+        duration_ = duration;
+        prev_ops_per_second_ = 0;
+        start_time_ = bench_clock_t::now();
+        print_start();
+
+        time_to_die_ = false;
+        thread_ = std::thread(&progress_t::request_progress, this);
+    }
+    inline void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (time_to_die_)
+                return;
+            time_to_die_ = true;
+        }
+        condition_.notify_one();
+        thread_.join();
+        print_end();
+    }
+
+    static void print_db_open() {
+        fmt::print("\33[2K\r");
+        fmt::print(" [✱] Opening DB...\r");
+        fflush(stdout);
+    }
+
+    static void print_db_close() {
+        fmt::print("\33[2K\r");
+        fmt::print(" [✱] Closing DB...\r");
+        fflush(stdout);
+    }
+
+    static void print_db_flush() {
+        fmt::print("\33[2K\r");
+        fmt::print(" [✱] Flushing DB...\r");
+        fflush(stdout);
+    }
+
+    static void clear_last_print() {
+        fmt::print("\33[2K\r");
+        fflush(stdout);
+    }
+
+  private:
+    void request_progress() {
+        bool time_to_die = false;
+        while (!time_to_die) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait_for(lock, std::chrono::milliseconds(request_delay_), [&] { return time_to_die_; });
+            time_to_die = time_to_die_;
+            if (!time_to_die)
+                print();
+        }
+    }
+
+    void print_start() {
+        fmt::print("\33[2K\r");
+        auto name = fmt::format(fmt::fg(fmt::color::light_green), "{}", workload_name_);
+        fmt::print(" [✱] {}: 0.00%\r", name, 0.0);
+        fflush(stdout);
+    }
+
+    void print_end() {
+        fmt::print("\33[2K\r");
+        fmt::print(" [✱] Completed\r");
+        fflush(stdout);
+    }
+
+    void print() {
+        auto counters = this->counters();
+        if (!counters.done_iterations || (!counters.total_iterations && duration_ <= 0))
+            return;
+
+        auto elapsed_time = bench_clock_t::now() - start_time_;
+        float done_percent = 0;
+        if (duration_ > 0)
+            done_percent = 100.0 * std::chrono::duration<double>(elapsed_time).count() / duration_;
+        if (counters.total_iterations)
+            done_percent = std::max(done_percent, 100.f * counters.done_iterations / counters.total_iterations);
+        done_percent = std::min(done_percent, 100.f);
+        auto fails_percent = counters.failed_iterations * 100.0 / counters.done_iterations;
+        auto ops_per_second = counters.entries_touched / std::chrono::duration<double>(elapsed_time).count();
+        auto opps_delta = int64_t(ops_per_second) - prev_ops_per_second_;
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed_time).count();
+        auto remaining = std::chrono::milliseconds(size_t((elapsed / done_percent) * (100.f - done_percent))).count();
+
+        fmt::print("\33[2K\r");
+        auto name = fmt::format(fmt::fg(fmt::color::light_green), "{}", workload_name_);
+        std::string delta;
+        if (opps_delta < 0 && std::abs(opps_delta) > prev_ops_per_second_ * 0.0001)
+            delta = fmt::format(fmt::fg(fmt::color::red), "▼");
+        else if (opps_delta > 0 && std::abs(opps_delta) > prev_ops_per_second_ * 0.0001)
+            delta = fmt::format(fmt::fg(fmt::color::green), "▲");
+        auto fails = fails_percent == 0.0 ? fmt::format("{:g}%", fails_percent)
+                                          : fmt::format(fmt::fg(fmt::color::red), "{:g}%", fails_percent);
+        fmt::print(" [✱] {}: {:.2f}% [{}/s {}| fails: {} | elapsed: {} | left: {}]\r",
+                   name,
+                   done_percent,
+                   printable_float_t {ops_per_second},
+                   delta,
+                   fails,
+                   printable_duration_t {size_t(elapsed)},
+                   printable_duration_t {size_t(remaining)});
+        fflush(stdout);
+
+        prev_ops_per_second_ = int64_t(ops_per_second);
+    }
+
+    std::vector<progress_slot_t> slots_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool time_to_die_;
+
+    size_t request_delay_;
+    std::string workload_name_;
+    double duration_ = 0;
+    time_point_t start_time_;
+    int64_t prev_ops_per_second_;
+};
+
+} // namespace ucsb
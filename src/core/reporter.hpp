@@ -3,6 +3,10 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <regex>
+#include <iterator>
 #include <iostream>
 #include <fstream>
 
@@ -11,6 +15,8 @@
 
 #include "src/core/types.hpp"
 #include "src/core/printable.hpp"
+#include "src/core/operation.hpp"
+#include "src/core/statistics.hpp"
 
 using ordered_json = nlohmann::ordered_json;
 
@@ -45,6 +51,13 @@ class console_reporter_t : public bm::BenchmarkReporter {
 
   private:
     double convert_duration(double duration, bm::TimeUnit from, bm::TimeUnit to);
+    void print_latencies(Run const& report);
+    void print_warmup(Run const& report);
+    void print_parts(Run const& report, std::string const& title, std::string const& prefix);
+    void print_statistics(std::vector<Run> const& aggregates);
+    void print_counters(Run const& report,
+                        std::string const& title,
+                        std::vector<std::pair<std::string, std::string>> const& counters);
 
   private:
     std::string title_;
@@ -52,6 +65,11 @@ class console_reporter_t : public bm::BenchmarkReporter {
     bool has_header_printed_;
 
     tabulate::Table::Row_t columns_;
+    std::vector<std::string> latency_percentiles_;
+    std::vector<std::string> statistics_;
+    std::vector<std::pair<std::string, std::string>> io_counters_;
+    std::vector<std::pair<std::string, std::string>> hw_counters_;
+    std::vector<std::pair<std::string, std::string>> transaction_counters_;
     size_t fails_column_idx_;
     size_t column_width_;
     size_t workload_column_width_;
@@ -77,6 +95,49 @@ inline console_reporter_t::console_reporter_t(std::string const& title, sections
 
     fails_column_idx_ = 8;
 
+    latency_percentiles_ = {
+        "p50",
+        "p90",
+        "p99",
+        "p99.9",
+        "max",
+    };
+
+    statistics_ = {
+        "mean",
+        "stddev",
+        "min",
+        "max",
+        "ci95",
+    };
+
+    io_counters_ = {
+        {"io_read,bytes", "Proc. read"},
+        {"io_write,bytes", "Proc. write"},
+        {"disk_read,bytes", "Disk read"},
+        {"disk_write,bytes", "Disk write"},
+        {"read_amp", "Read amp"},
+        {"write_amp", "Write amp"},
+        {"compression_ratio(est)", "Compr. ratio (est.)"},
+    };
+
+    hw_counters_ = {
+        {"ipc", "IPC"},
+        {"cycles/op", "Cycles/op"},
+        {"instructions/op", "Instrs/op"},
+        {"llc_loads/op", "LLC loads/op"},
+        {"llc_misses/op", "LLC miss/op"},
+        {"dtlb_misses/op", "dTLB miss/op"},
+        {"branch_misses/op", "Br. miss/op"},
+        {"context_switches/op", "Ctx sw./op"},
+    };
+
+    transaction_counters_ = {
+        {"transactions/s", "Txns/s"},
+        {"operations/transaction", "Ops/txn"},
+        {"aborts,%", "Aborts (%)"},
+    };
+
     column_width_ = 13;
     workload_column_width_ = 18;
     columns_total_width_ = workload_column_width_ + (columns_.size() - 1) * column_width_ + columns_.size() - 1;
@@ -117,12 +178,15 @@ void console_reporter_t::ReportRuns(std::vector<Run> const& reports) {
         std::cout << table << std::endl;
     }
 
-    if (sections_ & sections_t::result_k) {
-        if (reports.size() != 1) {
-            fmt::print("Each benchmark should be in separate group");
-            return;
-        }
-        auto const& report = reports.front();
+    if (!(sections_ & sections_t::result_k))
+        return;
+
+    // Note: Repetitions are reported together, then their aggregates are reported together
+    if (!reports.empty() && reports.front().run_type == Run::RT_Aggregate) {
+        print_statistics(reports);
+        return;
+    }
+    for (auto const& report : reports) {
 
         // Counters
         double throughput = report.counters.at("operations/s").value;
@@ -141,7 +205,10 @@ void console_reporter_t::ReportRuns(std::vector<Run> const& reports) {
 
         // Build table
         tabulate::Table table;
-        table.add_row({report.run_name.function_name,
+        std::string name = report.run_name.function_name;
+        if (report.repetitions > 1)
+            name = fmt::format("{} #{}", name, report.repetition_index + 1);
+        table.add_row({name,
                        fmt::format("{}/s", printable_float_t {throughput}),
                        fmt::format("{}", printable_bytes_t {data_processed}),
                        fmt::format("{}", printable_bytes_t {disk_usage}),
@@ -164,7 +231,217 @@ void console_reporter_t::ReportRuns(std::vector<Run> const& reports) {
 
         // Print
         std::cout << table << std::endl;
+        print_warmup(report);
+        print_latencies(report);
+        print_parts(report, "  Phases", "phase");
+        print_parts(report, "  Tenants", "tenant");
+        print_counters(report, "  Transactions", transaction_counters_);
+        print_counters(report, "  Storage", io_counters_);
+        print_counters(report, "  Hardware", hw_counters_);
+    }
+}
+
+void console_reporter_t::print_counters(Run const& report,
+                                        std::string const& title,
+                                        std::vector<std::pair<std::string, std::string>> const& counters) {
+
+    // Note: Only counters which were accessible are reported
+    tabulate::Table::Row_t header {title};
+    tabulate::Table::Row_t row {""};
+    for (auto const& [counter_name, column_name] : counters) {
+        auto it = report.counters.find(counter_name);
+        if (it == report.counters.end())
+            continue;
+        header.push_back(column_name);
+        double value = it->second.value;
+        if (counter_name.ends_with(",bytes"))
+            row.push_back(fmt::format("{}", printable_bytes_t {size_t(value)}));
+        else if (value < 1'000.0)
+            row.push_back(fmt::format("{:.3g}", value));
+        else
+            row.push_back(fmt::format("{}", printable_float_t {value}));
+    }
+    if (row.size() == 1)
+        return;
+
+    tabulate::Table table;
+    table.add_row(header);
+    table.add_row(row);
+    for (size_t row_idx = 0; row_idx != 2; ++row_idx)
+        table.row(row_idx).format().width(column_width_).font_align(tabulate::FontAlign::right).hide_border_top();
+    table.row(0).format().font_color(tabulate::Color::blue);
+    table.column(0).format().width(workload_column_width_).font_align(tabulate::FontAlign::left).locale("C");
+    std::cout << table << std::endl;
+}
+
+void console_reporter_t::print_warmup(Run const& report) {
+
+    auto operations_it = report.counters.find("warmup,operations");
+    if (operations_it == report.counters.end())
+        return;
+
+    size_t operations_count = operations_it->second.value;
+    double duration = report.counters.at("warmup,s").value * 1'000.0;
+    std::string note = fmt::format("  Warmup: {} operations in {}",
+                                   printable_float_t {double(operations_count)},
+                                   printable_duration_t {size_t(duration)});
+    auto cv_it = report.counters.find("warmup_cv,%");
+    if (cv_it != report.counters.end()) {
+        bool steady = report.counters.at("warmup_steady").value;
+        note += fmt::format(", {} (cv: {:.1f}%)", steady ? "steady" : "not steady", cv_it->second.value);
+    }
+
+    tabulate::Table table;
+    table.add_row({note});
+    table.row(0).format().width(columns_total_width_).font_align(tabulate::FontAlign::left).hide_border_top().locale("C");
+    std::cout << table << std::endl;
+}
+
+/**
+ * @brief Prints the stats of the parts of the workload, like phases or tenants,
+ * reported as counters starting with the `prefix` and the 1-based index of the part.
+ */
+void console_reporter_t::print_parts(Run const& report, std::string const& title, std::string const& prefix) {
+
+    size_t parts_count = 0;
+    while (report.counters.find(fmt::format("{}_{},operations/s", prefix, parts_count + 1)) != report.counters.end())
+        ++parts_count;
+    if (!parts_count)
+        return;
+
+    // Note: Only tail latencies of operations done in any of the parts are reported
+    std::vector<std::string> kind_names;
+    for (size_t kind_idx = 0; kind_idx != operation_kinds_count_k; ++kind_idx) {
+        auto kind_name = operation_kind_name(operation_kind_t(kind_idx));
+        for (size_t part_idx = 1; part_idx <= parts_count; ++part_idx) {
+            if (report.counters.find(fmt::format("{}_{},lat_p99({}),us", prefix, part_idx, kind_name)) !=
+                report.counters.end()) {
+                kind_names.push_back(kind_name);
+                break;
+            }
+        }
+    }
+
+    tabulate::Table table;
+    tabulate::Table::Row_t header {title, "operations/s", "duration", "fails,%"};
+    for (auto const& kind_name : kind_names)
+        header.push_back(fmt::format("p99({})", kind_name));
+    table.add_row(header);
+    for (size_t part_idx = 1; part_idx <= parts_count; ++part_idx) {
+        double throughput = report.counters.at(fmt::format("{}_{},operations/s", prefix, part_idx)).value;
+        double duration = report.counters.at(fmt::format("{}_{},s", prefix, part_idx)).value * 1'000.0;
+        double fails = report.counters.at(fmt::format("{}_{},fails,%", prefix, part_idx)).value;
+        tabulate::Table::Row_t row {fmt::format("  #{}", part_idx),
+                                    fmt::format("{}/s", printable_float_t {throughput}),
+                                    fmt::format("{}", printable_duration_t {size_t(duration)}),
+                                    fmt::format("{:g}", fails)};
+        for (auto const& kind_name : kind_names) {
+            auto it = report.counters.find(fmt::format("{}_{},lat_p99({}),us", prefix, part_idx, kind_name));
+            bool is_done = it != report.counters.end();
+            row.push_back(is_done ? fmt::format("{}", printable_latency_t {it->second.value}) : std::string("-"));
+        }
+        table.add_row(row);
     }
+
+    for (size_t row_idx = 0; row_idx <= parts_count; ++row_idx)
+        table.row(row_idx).format().width(column_width_).font_align(tabulate::FontAlign::right).hide_border_top();
+    table.row(0).format().font_color(tabulate::Color::blue);
+    table.column(0).format().width(workload_column_width_).font_align(tabulate::FontAlign::left).locale("C");
+    std::cout << table << std::endl;
+}
+
+void console_reporter_t::print_statistics(std::vector<Run> const& aggregates) {
+
+    auto find_aggregate = [&](std::string const& name) -> Run const* {
+        for (auto const& aggregate : aggregates)
+            if (aggregate.aggregate_name == name)
+                return &aggregate;
+        return nullptr;
+    };
+    Run const* mean = find_aggregate("mean");
+    Run const* ci95 = find_aggregate("ci95");
+    if (!mean)
+        return;
+
+    // Note: Throughput and tail latencies decide whether the run is stable
+    std::vector<std::pair<std::string, std::string>> metrics {{"operations/s", "  operations/s"}};
+    for (size_t kind_idx = 0; kind_idx != operation_kinds_count_k; ++kind_idx) {
+        auto kind_name = operation_kind_name(operation_kind_t(kind_idx));
+        auto counter_name = fmt::format("lat_p99({}),us", kind_name);
+        if (mean->counters.find(counter_name) != mean->counters.end())
+            metrics.emplace_back(counter_name, fmt::format("  p99({})", kind_name));
+    }
+
+    tabulate::Table table;
+    tabulate::Table::Row_t header {fmt::format("  {} runs", mean->repetitions)};
+    for (auto const& statistic : statistics_)
+        header.push_back(statistic == "ci95" ? "95% CI (±)" : statistic);
+    header.push_back("");
+    table.add_row(header);
+
+    std::vector<bool> unstable_rows;
+    for (auto const& [counter_name, metric_name] : metrics) {
+        bool is_latency = counter_name != "operations/s";
+        tabulate::Table::Row_t row {metric_name};
+        for (auto const& statistic : statistics_) {
+            Run const* aggregate = find_aggregate(statistic);
+            auto it = aggregate ? aggregate->counters.find(counter_name) : mean->counters.end();
+            if (!aggregate || it == aggregate->counters.end()) {
+                row.push_back("-");
+                continue;
+            }
+            double value = it->second.value;
+            row.push_back(is_latency ? fmt::format("{}", printable_latency_t {value})
+                                     : fmt::format("{}/s", printable_float_t {value}));
+        }
+        bool unstable = ci95 && is_unstable(mean->counters.at(counter_name).value, ci95->counters.at(counter_name).value);
+        row.push_back(unstable ? "unstable" : "");
+        unstable_rows.push_back(unstable);
+        table.add_row(row);
+    }
+
+    for (size_t row_idx = 0; row_idx <= metrics.size(); ++row_idx)
+        table.row(row_idx).format().width(column_width_).font_align(tabulate::FontAlign::right).hide_border_top();
+    table.row(0).format().font_color(tabulate::Color::blue);
+    table.column(0).format().width(workload_column_width_).font_align(tabulate::FontAlign::left).locale("C");
+    for (size_t row_idx = 0; row_idx != unstable_rows.size(); ++row_idx)
+        if (unstable_rows[row_idx])
+            table[row_idx + 1][statistics_.size() + 1].format().font_color(tabulate::Color::red);
+    std::cout << table << std::endl;
+}
+
+void console_reporter_t::print_latencies(Run const& report) {
+
+    // Note: Only operations which were actually done have latency counters
+    std::vector<tabulate::Table::Row_t> rows;
+    for (size_t kind_idx = 0; kind_idx != operation_kinds_count_k; ++kind_idx) {
+        auto kind_name = operation_kind_name(operation_kind_t(kind_idx));
+        if (report.counters.find(fmt::format("lat_max({}),us", kind_name)) == report.counters.end())
+            continue;
+
+        tabulate::Table::Row_t row {fmt::format("  {}", kind_name)};
+        for (auto const& percentile : latency_percentiles_) {
+            double latency = report.counters.at(fmt::format("lat_{}({}),us", percentile, kind_name)).value;
+            row.push_back(fmt::format("{}", printable_latency_t {latency}));
+        }
+        rows.push_back(row);
+    }
+    if (rows.empty())
+        return;
+
+    tabulate::Table table;
+    tabulate::Table::Row_t header {"  Latency"};
+    for (auto const& percentile : latency_percentiles_)
+        header.push_back(percentile);
+    table.add_row(header);
+    for (auto const& row : rows)
+        table.add_row(row);
+
+    for (size_t row_idx = 0; row_idx <= rows.size(); ++row_idx)
+        table.row(row_idx).format().width(column_width_).font_align(tabulate::FontAlign::right).hide_border_top();
+    table.row(0).format().font_color(tabulate::Color::blue);
+    table.column(0).format().width(workload_column_width_).font_align(tabulate::FontAlign::left).locale("C");
+    std::cout << table << std::endl;
 }
 
 void console_reporter_t::Finalize() {
@@ -207,10 +484,20 @@ double console_reporter_t::convert_duration(double duration, bm::TimeUnit from,
 
 class file_reporter_t {
   public:
-    static void merge_results(fs::path const& source_file_path, fs::path const& destination_file_path);
+    /**
+     * @brief Per-workload results, which don't fit into Google Benchmark counters.
+     * Keys are workload names, values are arrays of JSON objects, one per repetition,
+     * to be merged into the results of the matching repetition of the workload.
+     */
+    using extras_t = std::unordered_map<std::string, ordered_json>;
+
+    static void merge_results(fs::path const& source_file_path,
+                              fs::path const& destination_file_path,
+                              extras_t const& extras = {});
 
   private:
     static std::string parse_workload_name(std::string const& benchmark_name);
+    static void mark_unstable(ordered_json& j_benchmarks);
 };
 
 std::string file_reporter_t::parse_workload_name(std::string const& benchmark_name) {
@@ -223,14 +510,58 @@ std::string file_reporter_t::parse_workload_name(std::string const& benchmark_na
     return name;
 }
 
-void file_reporter_t::merge_results(fs::path const& source_file_path, fs::path const& destination_file_path) {
+void file_reporter_t::mark_unstable(ordered_json& j_benchmarks) {
+    for (auto& j_mean : j_benchmarks) {
+        if (j_mean.value("aggregate_name", "") != "mean")
+            continue;
+        auto run_name = j_mean["run_name"];
+        auto j_ci95 = std::find_if(j_benchmarks.begin(), j_benchmarks.end(), [&](ordered_json const& j_benchmark) {
+            return j_benchmark["run_name"] == run_name && j_benchmark.value("aggregate_name", "") == "ci95";
+        });
+        if (j_ci95 == j_benchmarks.end())
+            continue;
+
+        // Note: Throughput and tail latencies decide whether the run is stable
+        bool unstable = false;
+        for (auto const& j_counter : j_mean.items()) {
+            auto const& key = j_counter.key();
+            if (key != "operations/s" && !key.starts_with("lat_p99("))
+                continue;
+            if (j_counter.value().is_number() && j_ci95->contains(key))
+                unstable |= is_unstable(j_counter.value().get<double>(), (*j_ci95)[key].get<double>());
+        }
+        j_mean["unstable"] = unstable;
+    }
+}
+
+void file_reporter_t::merge_results(fs::path const& source_file_path,
+                                    fs::path const& destination_file_path,
+                                    extras_t const& extras) {
 
     if (!fs::exists(source_file_path))
         return;
 
+    // Note: Google Benchmark writes undefined statistics (e.g. cv of zeros) as NaN, which isn't valid JSON
     std::ifstream ifstream(source_file_path);
-    ordered_json j_source;
-    ifstream >> j_source;
+    std::string source((std::istreambuf_iterator<char>(ifstream)), std::istreambuf_iterator<char>());
+    source = std::regex_replace(source, std::regex(R"(:\s*-?(NaN|nan|Infinity|inf)\b)"), ": null");
+    ordered_json j_source = ordered_json::parse(source);
+
+    // Attach extras
+    for (auto& j_benchmark : j_source["benchmarks"]) {
+        if (j_benchmark.value("run_type", "") == "aggregate")
+            continue;
+        auto name = parse_workload_name(j_benchmark["name"].get<std::string>());
+        auto it = extras.find(name);
+        if (it == extras.end())
+            continue;
+        size_t repetition_idx = j_benchmark.value("repetition_index", size_t(0));
+        if (repetition_idx >= it->second.size() || !it->second[repetition_idx].is_object())
+            continue;
+        for (auto const& j_extra : it->second[repetition_idx].items())
+            j_benchmark[j_extra.key()] = j_extra.value();
+    }
+    mark_unstable(j_source["benchmarks"]);
 
     ordered_json j_destination;
     if (fs::exists(destination_file_path)) {
@@ -246,23 +577,29 @@ void file_reporter_t::merge_results(fs::path const& source_file_path, fs::path c
         for (auto it = j_destination_benchmarks.begin(); it != j_destination_benchmarks.end(); ++it)
             results.push_back(*it);
         // Update with new
-        for (auto it = j_source_benchmarks.begin(); it != j_source_benchmarks.end(); ++it) {
-            auto src_name = (*it)["name"].get<std::string>();
-            src_name = parse_workload_name(src_name);
-
-            size_t idx = 0;
-            for (; idx < results.size(); ++idx) {
-                auto dest_name = results[idx]["name"].get<std::string>();
-                dest_name = parse_workload_name(dest_name);
-                if (src_name == dest_name) {
-                    results[idx] = *it;
-                    break;
-                }
-            }
-            if (idx == results.size())
-                results.push_back(*it);
+        // Note: A workload may have several entries (repetitions and aggregates), all of them are replaced
+        std::vector<ordered_json> merged_results;
+        std::unordered_set<std::string> merged_names;
+        auto merge_source = [&](std::string const& name) {
+            if (!merged_names.insert(name).second)
+                return;
+            for (auto const& j_benchmark : j_source_benchmarks)
+                if (parse_workload_name(j_benchmark["name"].get<std::string>()) == name)
+                    merged_results.push_back(j_benchmark);
+        };
+        std::unordered_set<std::string> source_names;
+        for (auto const& j_benchmark : j_source_benchmarks)
+            source_names.insert(parse_workload_name(j_benchmark["name"].get<std::string>()));
+        for (auto const& result : results) {
+            auto dest_name = parse_workload_name(result["name"].get<std::string>());
+            if (source_names.contains(dest_name))
+                merge_source(dest_name);
+            else
+                merged_results.push_back(result);
         }
-        j_destination["benchmarks"] = results;
+        for (auto const& j_benchmark : j_source_benchmarks)
+            merge_source(parse_workload_name(j_benchmark["name"].get<std::string>()));
+        j_destination["benchmarks"] = merged_results;
     }
     else
         j_destination = j_source;
@@ -3,6 +3,7 @@
 #include <fstream>
 
 #include "src/core/types.hpp"
+#include "src/core/clock.hpp"
 
 namespace ucsb {
 
@@ -21,6 +22,10 @@ struct settings_t {
     fs::path results_file_path;
     size_t run_idx = 0;
     size_t runs_count = 0;
+    size_t repetitions = 1;
+    bool restore_db = false; // Restore the DB state before every repetition
+    size_t timeline_interval = 0; // In milliseconds, zero disables the timeline
+    clock_source_t clock_source = clock_source_t::monotonic_k;
 };
 
 } // namespace ucsb
\ No newline at end of file
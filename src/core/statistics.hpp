@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+namespace ucsb {
+
+/**
+ * @brief Runs, which 95% confidence interval half-width exceeds
+ * this fraction of the mean, are reported as unstable.
+ */
+constexpr double unstable_ci_ratio_k = 0.05;
+
+inline double min_statistic(std::vector<double> const& values) {
+    return values.empty() ? 0.0 : *std::min_element(values.begin(), values.end());
+}
+
+inline double max_statistic(std::vector<double> const& values) {
+    return values.empty() ? 0.0 : *std::max_element(values.begin(), values.end());
+}
+
+/**
+ * @brief Two-sided 97.5% quantile of the Student's t-distribution.
+ * Repetitions counts are small, so the normal approximation would be too optimistic.
+ */
+inline double student_t_975(size_t degrees_of_freedom) {
+    constexpr double quantiles_k[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+    };
+    constexpr size_t quantiles_count_k = sizeof(quantiles_k) / sizeof(quantiles_k[0]);
+    if (!degrees_of_freedom)
+        return 0.0;
+    return degrees_of_freedom <= quantiles_count_k ? quantiles_k[degrees_of_freedom - 1] : 1.960;
+}
+
+/**
+ * @brief Half-width of the 95% confidence interval of the mean.
+ */
+inline double ci95_statistic(std::vector<double> const& values) {
+    if (values.size() < 2)
+        return 0.0;
+    double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+    double variance = 0;
+    for (double value : values)
+        variance += (value - mean) * (value - mean);
+    variance /= values.size() - 1;
+    return student_t_975(values.size() - 1) * std::sqrt(variance / values.size());
+}
+
+inline bool is_unstable(double mean, double ci95) { return mean != 0.0 && ci95 > std::abs(mean) * unstable_ci_ratio_k; }
+
+} // namespace ucsb
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include "src/core/timer.hpp"
+#include "src/core/helper.hpp"
+#include "src/core/operation.hpp"
+#include "src/core/latency.hpp"
+#include "src/core/progress.hpp"
+
+namespace ucsb {
+
+/**
+ * @brief Stats of the threads of a single tenant, running concurrently with other tenants.
+ */
+struct tenant_stats_t {
+    std::string name;
+    size_t threads_count = 0;
+    double duration = 0; // In seconds, until the last thread of the tenant finished
+    size_t operations_count = 0;
+    double operations_per_second = 0;
+    double fails_percent = 0;
+    std::array<latency_percentiles_t, operation_kinds_count_k> latencies;
+};
+
+using tenants_stats_t = std::vector<tenant_stats_t>;
+
+/**
+ * @brief Aggregates the stats of consecutive threads of the same tenant.
+ * Must be called once all threads are done.
+ */
+inline tenants_stats_t make_tenants_stats(std::vector<std::string> const& threads_tenants,
+                                          std::vector<time_point_t> const& threads_end_times,
+                                          time_point_t start_time,
+                                          progress_t& progress,
+                                          std::vector<operation_latencies_t>& threads_latencies) {
+    tenants_stats_t tenants;
+    for (size_t first_idx = 0; first_idx != threads_tenants.size();) {
+        size_t last_idx = first_idx;
+        while (last_idx != threads_tenants.size() && threads_tenants[last_idx] == threads_tenants[first_idx])
+            ++last_idx;
+
+        size_t entries_touched = 0;
+        size_t failed_iterations = 0;
+        time_point_t end_time = start_time;
+        operation_latencies_t latencies;
+        tenant_stats_t stats;
+        for (size_t thread_idx = first_idx; thread_idx != last_idx; ++thread_idx) {
+            auto const& slot = progress.slot(thread_idx);
+            entries_touched += atomic_load(slot.entries_touched);
+            failed_iterations += atomic_load(slot.failed_iterations);
+            stats.operations_count += atomic_load(slot.done_iterations);
+            end_time = std::max(end_time, threads_end_times[thread_idx]);
+            latencies.merge(threads_latencies[thread_idx]);
+        }
+
+        stats.name = threads_tenants[first_idx];
+        stats.threads_count = last_idx - first_idx;
+        stats.duration = std::chrono::duration<double>(end_time - start_time).count();
+        stats.operations_per_second = stats.duration > 0 ? entries_touched / stats.duration : 0;
+        stats.fails_percent = stats.operations_count ? failed_iterations * 100.0 / stats.operations_count : 0;
+        for (size_t kind_idx = 0; kind_idx != operation_kinds_count_k; ++kind_idx)
+            stats.latencies[kind_idx] = latencies[operation_kind_t(kind_idx)].percentiles();
+        tenants.push_back(stats);
+        first_idx = last_idx;
+    }
+    return tenants;
+}
+
+/**
+ * @brief Converts the tenants stats into a JSON array, using the same naming
+ * for the stats as the final benchmark counters.
+ */
+inline nlohmann::ordered_json tenants_to_json(tenants_stats_t const& tenants) {
+    nlohmann::ordered_json j_tenants = nlohmann::ordered_json::array();
+    for (auto const& tenant : tenants) {
+        nlohmann::ordered_json j_tenant;
+        j_tenant["name"] = tenant.name;
+        j_tenant["threads"] = tenant.threads_count;
+        j_tenant["duration,s"] = tenant.duration;
+        j_tenant["operations"] = tenant.operations_count;
+        j_tenant["operations/s"] = tenant.operations_per_second;
+        j_tenant["fails,%"] = tenant.fails_percent;
+        for (size_t kind_idx = 0; kind_idx != operation_kinds_count_k; ++kind_idx) {
+            auto const& percentiles = tenant.latencies[kind_idx];
+            if (!percentiles.count)
+                continue;
+            auto kind_name = operation_kind_name(operation_kind_t(kind_idx));
+            j_tenant[fmt::format("lat_p50({}),us", kind_name)] = percentiles.p50 / 1'000.0;
+            j_tenant[fmt::format("lat_p90({}),us", kind_name)] = percentiles.p90 / 1'000.0;
+            j_tenant[fmt::format("lat_p99({}),us", kind_name)] = percentiles.p99 / 1'000.0;
+            j_tenant[fmt::format("lat_p99.9({}),us", kind_name)] = percentiles.p99_9 / 1'000.0;
+            j_tenant[fmt::format("lat_max({}),us", kind_name)] = percentiles.max / 1'000.0;
+        }
+        j_tenants.push_back(j_tenant);
+    }
+    return j_tenants;
+}
+
+} // namespace ucsb
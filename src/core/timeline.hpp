@@ -0,0 +1,201 @@
+#pragma once
+
+#include <sys/times.h>
+#include <unistd.h>
+#include <array>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <condition_variable>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include "src/core/timer.hpp"
+#include "src/core/operation.hpp"
+#include "src/core/latency.hpp"
+
+namespace ucsb {
+
+/**
+ * @brief Cumulative operation counters of all threads, sampled by the timeline.
+ */
+struct timeline_counters_t {
+    size_t entries_touched = 0;
+    size_t done_iterations = 0;
+    size_t failed_iterations = 0;
+};
+
+/**
+ * @brief Stats of a single timeline interval.
+ */
+struct timeline_point_t {
+    double time = 0; // In seconds since the start, at the end of the interval
+    double operations_per_second = 0;
+    double fails_percent = 0;
+    double cpu_percent = 0;
+    size_t rss = 0;
+    std::array<latency_percentiles_t, operation_kinds_count_k> latencies;
+};
+
+using timeline_t = std::vector<timeline_point_t>;
+
+/**
+ * @brief Manages a sibling thread, that snapshots throughput, latencies,
+ * failures and resource usage at a fixed period. Unlike the end-of-run
+ * averages, the series exposes stalls caused by compactions or checkpoints.
+ */
+class timeline_recorder_t {
+  public:
+    using counters_sampler_t = std::function<timeline_counters_t()>;
+    using threads_latencies_t = std::vector<operation_latencies_t>;
+
+    inline timeline_recorder_t(size_t request_delay,
+                               counters_sampler_t counters_sampler,
+                               threads_latencies_t& threads_latencies)
+        : time_to_die_(true), request_delay_(request_delay), counters_sampler_(std::move(counters_sampler)),
+          threads_latencies_(&threads_latencies), page_size_(sysconf(_SC_PAGE_SIZE)) {}
+    ~timeline_recorder_t() { stop(); }
+
+    inline void start() {
+        if (!time_to_die_ || !request_delay_)
+            return;
+
+        timeline_.clear();
+        time_to_die_ = false;
+        thread_ = std::thread(&timeline_recorder_t::record, this);
+    }
+    inline void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (time_to_die_)
+                return;
+            time_to_die_ = true;
+        }
+        condition_.notify_one();
+        thread_.join();
+    }
+
+    inline timeline_t const& timeline() const { return timeline_; }
+
+  private:
+    struct snapshot_t {
+        time_point_t time;
+        timeline_counters_t counters;
+        operation_latencies_t latencies;
+        clock_t cpu = 0;
+        clock_t proc = 0;
+    };
+
+    void record() {
+        snapshot_t last;
+        take_snapshot(last);
+
+        bool time_to_die = false;
+        while (!time_to_die) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                condition_.wait_for(lock, std::chrono::milliseconds(request_delay_), [&] { return time_to_die_; });
+                time_to_die = time_to_die_;
+            }
+
+            snapshot_t current;
+            take_snapshot(current);
+            timeline_.push_back(make_point(last, current));
+            std::swap(last, current);
+        }
+    }
+
+    inline void take_snapshot(snapshot_t& snapshot) {
+        snapshot.time = bench_clock_t::now();
+        snapshot.counters = counters_sampler_();
+        for (auto& thread_latencies : *threads_latencies_)
+            snapshot.latencies.merge(thread_latencies);
+
+        tms time_sample;
+        snapshot.cpu = times(&time_sample);
+        snapshot.proc = time_sample.tms_utime + time_sample.tms_stime;
+    }
+
+    inline timeline_point_t make_point(snapshot_t const& last, snapshot_t& current) {
+        timeline_point_t point;
+        if (timeline_.empty())
+            start_time_ = last.time;
+        point.time = std::chrono::duration<double>(current.time - start_time_).count();
+
+        double interval = std::chrono::duration<double>(current.time - last.time).count();
+        size_t entries_touched = current.counters.entries_touched - last.counters.entries_touched;
+        size_t done_iterations = current.counters.done_iterations - last.counters.done_iterations;
+        size_t failed_iterations = current.counters.failed_iterations - last.counters.failed_iterations;
+        point.operations_per_second = interval > 0 ? entries_touched / interval : 0;
+        point.fails_percent = done_iterations ? failed_iterations * 100.0 / done_iterations : 0;
+
+        clock_t delta_cpu = current.cpu - last.cpu;
+        point.cpu_percent = delta_cpu > 0 ? 100.0 * (current.proc - last.proc) / delta_cpu : 0;
+        point.rss = rss();
+
+        // Note: The cumulative snapshot is still needed for the next interval
+        operation_latencies_t interval_latencies;
+        interval_latencies.merge(current.latencies);
+        interval_latencies.subtract(last.latencies);
+        for (size_t kind_idx = 0; kind_idx != operation_kinds_count_k; ++kind_idx)
+            point.latencies[kind_idx] = interval_latencies[operation_kind_t(kind_idx)].percentiles();
+
+        return point;
+    }
+
+    inline size_t rss() const {
+        size_t vm = 0, rss = 0;
+        std::ifstream statm("/proc/self/statm", std::ios_base::in);
+        statm >> vm >> rss;
+        return rss * page_size_;
+    }
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool time_to_die_;
+
+    size_t request_delay_;
+    counters_sampler_t counters_sampler_;
+    threads_latencies_t* threads_latencies_;
+    size_t page_size_;
+
+    time_point_t start_time_;
+    timeline_t timeline_;
+};
+
+/**
+ * @brief Converts the timeline into a JSON array, using the same naming
+ * for the stats as the final benchmark counters.
+ */
+inline nlohmann::ordered_json timeline_to_json(timeline_t const& timeline) {
+    nlohmann::ordered_json j_timeline = nlohmann::ordered_json::array();
+    for (auto const& point : timeline) {
+        nlohmann::ordered_json j_point;
+        j_point["time,s"] = point.time;
+        j_point["operations/s"] = point.operations_per_second;
+        j_point["fails,%"] = point.fails_percent;
+        j_point["cpu,%"] = point.cpu_percent;
+        j_point["mem(rss),bytes"] = point.rss;
+        for (size_t kind_idx = 0; kind_idx != operation_kinds_count_k; ++kind_idx) {
+            auto const& percentiles = point.latencies[kind_idx];
+            if (!percentiles.count)
+                continue;
+            auto kind_name = operation_kind_name(operation_kind_t(kind_idx));
+            j_point[fmt::format("lat_p50({}),us", kind_name)] = percentiles.p50 / 1'000.0;
+            j_point[fmt::format("lat_p90({}),us", kind_name)] = percentiles.p90 / 1'000.0;
+            j_point[fmt::format("lat_p99({}),us", kind_name)] = percentiles.p99 / 1'000.0;
+            j_point[fmt::format("lat_p99.9({}),us", kind_name)] = percentiles.p99_9 / 1'000.0;
+            j_point[fmt::format("lat_max({}),us", kind_name)] = percentiles.max / 1'000.0;
+        }
+        j_timeline.push_back(j_point);
+    }
+    return j_timeline;
+}
+
+} // namespace ucsb
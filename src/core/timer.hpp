@@ -1,19 +1,22 @@
 #pragma once
 
 #include <chrono>
+#include <cassert>
 #include <benchmark/benchmark.h>
 
+#include "src/core/clock.hpp"
+
 namespace bm = benchmark;
 
 namespace ucsb {
 
-using high_resolution_clock_t = std::chrono::high_resolution_clock;
-using time_point_t = std::chrono::time_point<high_resolution_clock_t>;
+using time_point_t = bench_clock_t::time_point;
 using elapsed_time_t = std::chrono::nanoseconds;
 
 /**
- * @brief Trivial Google Benchmark wrapper.
- * No added value here :)
+ * @brief Google Benchmark timer replacement.
+ * Pauses are accounted locally instead of calling `PauseTiming`/`ResumeTiming`
+ * on every batch, and the operations time is reported as manual time on stop.
  */
 class timer_t {
   public:
@@ -25,42 +28,53 @@ class timer_t {
 
     inline timer_t(bm::State& bench) : bench_(&bench), state_(state_t::stopped_k) {}
 
-    // Google benchmark timer methods
-    void __attribute__ ((noinline)) pause() {
-        bench_->PauseTiming();
-
+    inline void pause() {
         assert(state_ == state_t::running_k);
         recalculate_operations_elapsed_time();
+        pause_time_ = operations_start_time_;
         state_ = state_t::paused_k;
     }
-    void __attribute__ ((noinline)) resume() {
+    inline void resume() {
         assert(state_ == state_t::paused_k);
-        operations_start_time_ = high_resolution_clock_t::now();
+        operations_start_time_ = bench_clock_t::now();
+        paused_elapsed_time_ += operations_start_time_ - pause_time_;
         state_ = state_t::running_k;
-
-        bench_->ResumeTiming();
     }
 
     // Helper methods to calculate real time statistics
-    void __attribute__ ((noinline)) start() {
+    void start() {
         assert(state_ == state_t::stopped_k);
         elapsed_time_ = elapsed_time_t(0);
         operations_elapsed_time_ = elapsed_time_t(0);
-        auto now = high_resolution_clock_t::now();
+        paused_elapsed_time_ = elapsed_time_t(0);
+        auto now = bench_clock_t::now();
         start_time_ = now;
         operations_start_time_ = now;
         state_ = state_t::running_k;
     }
-    void __attribute__ ((noinline)) stop() {
+    void stop() {
         assert(state_ == state_t::running_k);
         recalculate_operations_elapsed_time();
         state_ = state_t::stopped_k;
+        bench_->SetIterationTime(std::chrono::duration<double>(operations_elapsed_time_).count());
+    }
+    /**
+     * @brief Stops the timer without reporting the elapsed time, e.g. after a warmup.
+     */
+    void discard() {
+        assert(state_ == state_t::running_k);
+        state_ = state_t::stopped_k;
     }
     inline auto operations_elapsed_time() {
         if (state_ == state_t::running_k)
             recalculate_operations_elapsed_time();
         return operations_elapsed_time_;
     }
+    /**
+     * @brief Total time spent in pauses since start.
+     * Used to exclude data preparation from single operation latencies.
+     */
+    inline auto paused_elapsed_time() const { return paused_elapsed_time_; }
     inline auto elapsed_time() {
         if (state_ != state_t::stopped_k)
             recalculate_elapsed_time();
@@ -69,13 +83,13 @@ class timer_t {
 
   private:
     void recalculate_operations_elapsed_time() {
-        auto now = high_resolution_clock_t::now();
-        operations_elapsed_time_ += std::chrono::duration_cast<elapsed_time_t>(now - operations_start_time_);
+        auto now = bench_clock_t::now();
+        operations_elapsed_time_ += now - operations_start_time_;
         operations_start_time_ = now;
     }
     void recalculate_elapsed_time() {
-        auto now = high_resolution_clock_t::now();
-        elapsed_time_ += std::chrono::duration_cast<elapsed_time_t>(now - start_time_);
+        auto now = bench_clock_t::now();
+        elapsed_time_ += now - start_time_;
         start_time_ = now;
     }
 
@@ -90,6 +104,9 @@ class timer_t {
     //
     time_point_t operations_start_time_;
     elapsed_time_t operations_elapsed_time_;
+    //
+    time_point_t pause_time_;
+    elapsed_time_t paused_elapsed_time_;
 };
 
 } // namespace ucsb
\ No newline at end of file
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <span>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "src/core/types.hpp"
+#include "src/core/helper.hpp"
+#include "src/core/exception.hpp"
+#include "src/core/operation.hpp"
+
+namespace ucsb {
+
+/**
+ * @brief A single operation of a trace.
+ * Batch operations are traced as separate single-key operations.
+ */
+struct trace_record_t {
+    uint64_t key = 0;
+    uint64_t timestamp = 0; // In nanoseconds since the trace start
+    uint32_t length = 0;    // Value length, or the number of entries for range selects and scans
+    uint8_t kind = 0;       // `operation_kind_t`
+    uint8_t reserved[3] = {0, 0, 0};
+};
+static_assert(sizeof(trace_record_t) == 24, "Trace records are stored as is");
+
+using trace_records_t = std::vector<trace_record_t>;
+
+/**
+ * @brief Whether the operation can be replayed from a trace record.
+ * Batches are traced as their single-key operations, and commits aren't traced at all.
+ */
+inline bool is_traced_operation(operation_kind_t kind) {
+    switch (kind) {
+    case operation_kind_t::upsert_k:
+    case operation_kind_t::update_k:
+    case operation_kind_t::remove_k:
+    case operation_kind_t::read_k:
+    case operation_kind_t::read_modify_write_k:
+    case operation_kind_t::range_select_k:
+    case operation_kind_t::scan_k: return true;
+    default: return false;
+    }
+}
+
+/**
+ * @brief Header of the binary trace file, followed by the records.
+ */
+struct trace_header_t {
+    static constexpr uint32_t version_k = 1;
+    static constexpr uint32_t has_timestamps_k = 0x01;
+
+    char magic[8] = {'U', 'C', 'S', 'B', 'T', 'R', 'C', '\0'};
+    uint32_t version = version_k;
+    uint32_t flags = 0;
+    uint64_t records_count = 0;
+    uint64_t reserved = 0;
+
+    inline bool is_valid() const noexcept {
+        return std::memcmp(magic, trace_header_t {}.magic, sizeof(magic)) == 0 && version == version_k;
+    }
+};
+static_assert(sizeof(trace_header_t) == 32, "Trace header is stored as is");
+
+/**
+ * @brief Read-only memory-mapped binary trace.
+ */
+class trace_t {
+  public:
+    inline trace_t(fs::path const& path) : fd_(-1), data_(nullptr), size_(0) {
+        fd_ = open(path.c_str(), O_RDONLY);
+        if (fd_ < 0)
+            throw exception_t(fmt::format("Failed to open trace: {}", path.string()));
+        struct stat file_stat;
+        if (fstat(fd_, &file_stat) != 0 || size_t(file_stat.st_size) < sizeof(trace_header_t))
+            throw exception_t(fmt::format("Invalid trace: {}", path.string()));
+        size_ = file_stat.st_size;
+
+        data_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+        if (data_ == MAP_FAILED) {
+            data_ = nullptr;
+            throw exception_t(fmt::format("Failed to map trace: {}", path.string()));
+        }
+        // Note: Records are mostly streamed sequentially
+        madvise(data_, size_, MADV_SEQUENTIAL);
+
+        if (!header().is_valid() || sizeof(trace_header_t) + header().records_count * sizeof(trace_record_t) > size_)
+            throw exception_t(fmt::format("Invalid trace: {}", path.string()));
+    }
+    ~trace_t() {
+        if (data_)
+            munmap(data_, size_);
+        if (fd_ >= 0)
+            close(fd_);
+    }
+
+    trace_t(trace_t const&) = delete;
+    trace_t& operator=(trace_t const&) = delete;
+
+    inline trace_header_t const& header() const noexcept { return *reinterpret_cast<trace_header_t const*>(data_); }
+    inline bool has_timestamps() const noexcept { return header().flags & trace_header_t::has_timestamps_k; }
+    inline std::span<trace_record_t const> records() const noexcept {
+        auto begin = reinterpret_cast<trace_record_t const*>(reinterpret_cast<char const*>(data_) +
+                                                             sizeof(trace_header_t));
+        return {begin, header().records_count};
+    }
+
+  private:
+    int fd_;
+    void* data_;
+    size_t size_;
+};
+
+/**
+ * @brief Streams the part of the trace replayed by a single thread.
+ * Records are assigned to threads by the key hash, so all operations
+ * on the same key are replayed by the same thread in the trace order.
+ * Records of the thread are collected once, before the benchmark starts,
+ * so the replay doesn't skip the records of other threads.
+ */
+class trace_cursor_t {
+  public:
+    inline trace_cursor_t() noexcept : threads_count_(0), position_(0) {}
+    inline trace_cursor_t(std::span<trace_record_t const> records, size_t thread_idx, size_t threads_count)
+        : records_(records), threads_count_(threads_count), position_(0) {
+        for (size_t idx = 0; idx != records_.size(); ++idx)
+            if (owner(records_[idx].key) == thread_idx)
+                indices_.push_back(idx);
+    }
+
+    inline bool is_enabled() const noexcept { return threads_count_ != 0; }
+
+    /**
+     * @return The next record of this thread, or `nullptr` once the trace is exhausted.
+     */
+    inline trace_record_t const* next() noexcept {
+        return position_ < indices_.size() ? &records_[indices_[position_++]] : nullptr;
+    }
+
+    /**
+     * @return Timestamp of the next record of this thread, without consuming it.
+     */
+    inline uint64_t peek_timestamp() const noexcept {
+        return position_ < indices_.size() ? records_[indices_[position_]].timestamp : UINT64_MAX;
+    }
+
+  private:
+    inline size_t owner(uint64_t key) const noexcept {
+        // Note: Keys are often sequential, so they are mixed first (SplitMix64 finalizer)
+        key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+        key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+        key = key ^ (key >> 31);
+        return key % threads_count_;
+    }
+
+    std::span<trace_record_t const> records_;
+    std::vector<size_t> indices_;
+    size_t threads_count_;
+    size_t position_;
+};
+
+inline void write_trace(fs::path const& path, trace_records_t const& records, bool has_timestamps) {
+    trace_header_t header;
+    header.flags = has_timestamps ? trace_header_t::has_timestamps_k : 0;
+    header.records_count = records.size();
+
+    std::ofstream ofstream(path, std::ios::binary | std::ios::trunc);
+    ofstream.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    ofstream.write(reinterpret_cast<char const*>(records.data()), records.size() * sizeof(trace_record_t));
+    if (!ofstream)
+        throw exception_t(fmt::format("Failed to write trace: {}", path.string()));
+}
+
+/**
+ * @brief Merges traces recorded by separate threads into one, ordered by timestamps.
+ */
+inline trace_records_t merge_traces(std::vector<trace_records_t> const& threads_records) {
+    trace_records_t records;
+    size_t records_count = 0;
+    for (auto const& thread_records : threads_records)
+        records_count += thread_records.size();
+    records.reserve(records_count);
+    for (auto const& thread_records : threads_records) {
+        auto middle = records.insert(records.end(), thread_records.begin(), thread_records.end());
+        std::inplace_merge(records.begin(), middle, records.end(), [](auto const& left, auto const& right) {
+            return left.timestamp < right.timestamp;
+        });
+    }
+    return records;
+}
+
+/**
+ * @brief Converts a text access log into a binary trace.
+ * Every line is `operation,key[,length[,timestamp]]`, where operation is the
+ * `operation_kind_name()` of a single-key operation or a range, and timestamp is in nanoseconds. Empty lines and
+ * lines starting with `#` are skipped. Timestamps, if present, must be present
+ * in all lines, and are rebased to start from zero.
+ */
+inline void import_trace(fs::path const& log_path, fs::path const& trace_path) {
+    std::ifstream ifstream(log_path);
+    if (!ifstream)
+        throw exception_t(fmt::format("Failed to open access log: {}", log_path.string()));
+
+    trace_records_t records;
+    bool has_timestamps = false;
+    std::string line;
+    for (size_t line_idx = 1; std::getline(ifstream, line); ++line_idx) {
+        if (line.empty() || line.front() == '#')
+            continue;
+
+        auto tokens = split(line, ',');
+        bool is_valid = tokens.size() >= 2 && tokens.size() <= 4;
+        trace_record_t record;
+        size_t kind_idx = 0;
+        for (; is_valid && kind_idx != operation_kinds_count_k; ++kind_idx)
+            if (tokens[0] == operation_kind_name(operation_kind_t(kind_idx)))
+                break;
+        is_valid &= kind_idx != operation_kinds_count_k;
+        if (is_valid && !is_traced_operation(operation_kind_t(kind_idx)))
+            throw exception_t(fmt::format("Unsupported operation in access log line {}: {}", line_idx, line));
+        try {
+            if (is_valid) {
+                record.kind = uint8_t(kind_idx);
+                record.key = std::stoull(tokens[1]);
+                record.length = tokens.size() > 2 ? std::stoul(tokens[2]) : 0;
+                record.timestamp = tokens.size() > 3 ? std::stoull(tokens[3]) : 0;
+            }
+        }
+        catch (std::exception const&) {
+            is_valid = false;
+        }
+        if (records.empty())
+            has_timestamps = tokens.size() > 3;
+        is_valid &= has_timestamps == (tokens.size() > 3);
+        if (!is_valid)
+            throw exception_t(fmt::format("Invalid access log line {}: {}", line_idx, line));
+        records.push_back(record);
+    }
+
+    if (has_timestamps && !records.empty()) {
+        std::stable_sort(records.begin(), records.end(), [](auto const& left, auto const& right) {
+            return left.timestamp < right.timestamp;
+        });
+        uint64_t start = records.front().timestamp;
+        for (auto& record : records)
+            record.timestamp -= start;
+    }
+    write_trace(trace_path, records, has_timestamps);
+}
+
+} // namespace ucsb
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+
+#include "src/core/types.hpp"
+
+namespace ucsb {
+
+/**
+ * @brief Open-addressing set of keys, reused across batches without any allocation.
+ * Every slot is stamped with the epoch it was filled in, so `clear()` only starts a new epoch,
+ * and slots of older epochs count as empty.
+ */
+class unique_keys_t {
+  public:
+    inline unique_keys_t() noexcept : mask_(0), epoch_(0), count_(0), max_count_(0) {}
+    /**
+     * @param max_count The most keys inserted between two `clear()` calls.
+     */
+    inline unique_keys_t(size_t max_count) : epoch_(1), count_(0), max_count_(max_count) {
+        // Note: At most half of the slots are filled, to keep the probe sequences short
+        size_t capacity = 16;
+        while (capacity < max_count * 2)
+            capacity *= 2;
+        mask_ = capacity - 1;
+        keys_.resize(capacity);
+        epochs_.resize(capacity, 0);
+    }
+
+    inline void clear() noexcept {
+        count_ = 0;
+        if (++epoch_ != 0)
+            return;
+        std::fill(epochs_.begin(), epochs_.end(), 0);
+        epoch_ = 1;
+    }
+
+    /**
+     * @return False, if the key was already inserted since the last `clear()`.
+     */
+    inline bool insert(key_t key) noexcept {
+        assert(count_ < max_count_);
+        for (size_t idx = hash(key) & mask_;; idx = (idx + 1) & mask_) {
+            if (epochs_[idx] != epoch_) {
+                epochs_[idx] = epoch_;
+                keys_[idx] = key;
+                ++count_;
+                return true;
+            }
+            if (keys_[idx] == key)
+                return false;
+        }
+    }
+
+  private:
+    static inline size_t hash(key_t key) noexcept {
+        // Note: Fibonacci hashing, the upper bits are the best mixed ones
+        uint64_t mixed = uint64_t(key) * 0x9E3779B97F4A7C15ull;
+        return size_t(mixed ^ (mixed >> 32));
+    }
+
+    std::vector<key_t> keys_;
+    std::vector<uint32_t> epochs_;
+    size_t mask_;
+    uint32_t epoch_;
+    size_t count_;
+    size_t max_count_;
+};
+
+} // namespace ucsb
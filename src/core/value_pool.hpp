@@ -0,0 +1,198 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <memory>
+#include <vector>
+#include <cstring>
+#include <cassert>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "src/core/types.hpp"
+#include "src/core/workload.hpp"
+#include "src/core/huge_buffer.hpp"
+#include "src/core/generators/random_generator.hpp"
+
+namespace ucsb {
+
+/**
+ * @brief Random bytes generated once, which written values are views into.
+ * Pools are read-only, so all threads and phases with the same value settings share one.
+ * The bytes follow the `value_profile` and `value_compressibility` of the workload.
+ */
+class value_pool_t {
+  public:
+    static constexpr size_t window_size_k = 16 * 1024 * 1024;
+
+    /**
+     * @param max_length The longest slice, which will be requested.
+     */
+    inline value_pool_t(workload_t const& workload, size_t max_length)
+        : buffer_(window_size_k + max_length), max_length_(max_length) {
+        std::span<std::byte> bytes(buffer_.data(), window_size_k + max_length);
+        core::random_engine_t engine(workload.seed);
+        switch (workload.value_profile) {
+        case value_profile_t::random_k: fill_random(bytes, workload.value_compressibility, engine); break;
+        case value_profile_t::text_k: fill_text(bytes, engine); break;
+        case value_profile_t::zero_padded_k:
+            fill_zero_padded(bytes, workload.value_length, workload.value_compressibility, engine);
+            break;
+        case value_profile_t::json_k: fill_json(bytes, engine); break;
+        default: fill_printable(bytes, engine); break;
+        }
+    }
+
+    inline std::byte const* data() const noexcept { return buffer_.data(); }
+    inline size_t max_length() const noexcept { return max_length_; }
+
+  private:
+    static constexpr size_t fragment_length_k = 256;
+    static constexpr size_t words_count_k = 1024;
+
+    static void fill_printable(std::span<std::byte> bytes, core::random_engine_t& engine) {
+        core::random_byte_generator_t generator;
+        generator.seed(engine);
+        for (auto& byte : bytes)
+            byte = std::byte(generator.generate());
+    }
+
+    /**
+     * @brief Every fragment starts with random bytes, which are repeated till its end,
+     * so LZ-family compressors shrink it by the `compressibility` ratio.
+     */
+    static void fill_random(std::span<std::byte> bytes, double compressibility, core::random_engine_t& engine) {
+        size_t unique_length = std::max<size_t>(fragment_length_k / compressibility, 1);
+        for (size_t offset = 0; offset < bytes.size(); offset += fragment_length_k) {
+            size_t length = std::min(fragment_length_k, bytes.size() - offset);
+            std::byte* fragment = bytes.data() + offset;
+            for (size_t i = 0; i != length; ++i)
+                fragment[i] = i < unique_length ? std::byte(engine()) : fragment[i % unique_length];
+        }
+    }
+
+    static void fill_zero_padded(std::span<std::byte> bytes,
+                                 size_t value_length,
+                                 double compressibility,
+                                 core::random_engine_t& engine) {
+        size_t unique_length = std::max<size_t>(value_length / compressibility, 1);
+        for (size_t i = 0; i != bytes.size(); ++i)
+            bytes[i] = i % value_length < unique_length ? std::byte(engine()) : std::byte(0);
+    }
+
+    static void fill_text(std::span<std::byte> bytes, core::random_engine_t& engine) {
+        std::vector<std::string> words = make_words(engine);
+        size_t offset = 0;
+        while (offset < bytes.size()) {
+            std::string const& word = words[skewed_index(engine)];
+            char separator = engine() % 16 ? ' ' : (engine() % 4 ? '.' : '\n');
+            offset = append(bytes, offset, word);
+            offset = append(bytes, offset, std::string_view(&separator, 1));
+        }
+    }
+
+    static void fill_json(std::span<std::byte> bytes, core::random_engine_t& engine) {
+        std::vector<std::string> words = make_words(engine);
+        size_t offset = 0;
+        while (offset < bytes.size()) {
+            std::string document = fmt::format(
+                R"({{"id":{},"name":"{}","email":"{}@example.com","age":{},"active":{},"score":{:.2f},"tags":["{}","{}"]}})",
+                engine() % 100'000'000,
+                words[skewed_index(engine)],
+                words[skewed_index(engine)],
+                18 + engine() % 80,
+                engine() % 2 ? "true" : "false",
+                (engine() % 10'000) / 100.0,
+                words[skewed_index(engine)],
+                words[skewed_index(engine)]);
+            offset = append(bytes, offset, document);
+        }
+    }
+
+    static std::vector<std::string> make_words(core::random_engine_t& engine) {
+        std::vector<std::string> words(words_count_k);
+        for (auto& word : words) {
+            word.resize(2 + engine() % 9);
+            for (auto& letter : word)
+                letter = char('a' + engine() % 26);
+        }
+        return words;
+    }
+
+    /**
+     * @brief Frequent words are more likely, like in natural texts.
+     */
+    static size_t skewed_index(core::random_engine_t& engine) { return engine() % (engine() % words_count_k + 1); }
+
+    static size_t append(std::span<std::byte> bytes, size_t offset, std::string_view text) {
+        size_t length = std::min(text.size(), bytes.size() - offset);
+        std::memcpy(bytes.data() + offset, text.data(), length);
+        return offset + length;
+    }
+
+    huge_buffer_t buffer_;
+    size_t max_length_;
+};
+
+/**
+ * @brief Pools of all threads, by the value settings, which their bytes depend on.
+ */
+class value_pools_t {
+  public:
+    inline value_pool_t const& pool(workload_t const& workload, size_t max_length) {
+        signature_t signature {workload.value_profile,
+                               workload.value_compressibility,
+                               workload.value_length,
+                               max_length,
+                               workload.seed};
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& pool = pools_[signature];
+        if (!pool)
+            pool = std::make_unique<value_pool_t>(workload, max_length);
+        return *pool;
+    }
+
+    inline void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pools_.clear();
+    }
+
+  private:
+    using signature_t = std::tuple<value_profile_t, double, size_t, size_t, size_t>;
+
+    std::map<signature_t, std::unique_ptr<value_pool_t>> pools_;
+    std::mutex mutex_;
+};
+
+/**
+ * @brief Takes the values of a single worker from a shared `value_pool_t`.
+ * Every request takes the next slice of the pool, so consecutive values differ,
+ * but no bytes are generated in the benchmark loop.
+ */
+class value_cursor_t {
+  public:
+    inline value_cursor_t() noexcept : pool_(nullptr), offset_(0) {}
+    /**
+     * @brief Every worker starts at its own offset, so threads don't write the same values.
+     */
+    inline value_cursor_t(value_pool_t const& pool, core::random_engine_t& streams) noexcept
+        : pool_(&pool), offset_(streams.split()() % value_pool_t::window_size_k) {}
+
+    inline values_spanc_t take(size_t length) noexcept {
+        assert(length <= pool_->max_length());
+        values_spanc_t values(pool_->data() + offset_, length);
+        // Note: The odd shift keeps slices from repeating with the same alignment after wrapping around
+        offset_ = (offset_ + length + 1) % value_pool_t::window_size_k;
+        return values;
+    }
+
+  private:
+    value_pool_t const* pool_;
+    size_t offset_;
+};
+
+} // namespace ucsb
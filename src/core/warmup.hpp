@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cmath>
+#include <deque>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <numeric>
+#include <condition_variable>
+
+#include "src/core/timer.hpp"
+#include "src/core/workload.hpp"
+#include "src/core/progress.hpp"
+
+namespace ucsb {
+
+/**
+ * @brief Summary of the warmup applied before a workload.
+ */
+struct warmup_stats_t {
+    size_t operations_count = 0;
+    double duration = 0;      // In seconds
+    double throughput_cv = 0; // Coefficient of variation of the last intervals throughput
+    bool steady = false;      // Whether the steady state was detected, instead of hitting the limit
+};
+
+/**
+ * @brief Manages a sibling thread, that decides when the warmup is over.
+ *
+ * The warmup lasts at least `warmup_duration` seconds. If `steady_state_cv` is set,
+ * it continues until the coefficient of variation of the throughput over the last
+ * `steady_state_intervals_k` intervals drops below it, but no longer than
+ * `steady_state_max_duration` seconds. Threads additionally complete their own
+ * `warmup_operations_count` operations before leaving the warmup.
+ */
+class warmup_monitor_t {
+  public:
+    static constexpr size_t interval_k = 250; // In milliseconds
+    static constexpr size_t steady_state_intervals_k = 8;
+
+    inline warmup_monitor_t(progress_t& progress)
+        : workload_(nullptr), progress_(&progress), done_(true), time_to_die_(true) {}
+    ~warmup_monitor_t() { stop(); }
+
+    static inline bool is_enabled(workload_t const& workload) noexcept {
+        return workload.db_warmup_operations_count || workload.warmup_duration > 0 || workload.steady_state_cv > 0;
+    }
+
+    inline void start(workload_t const& workload) {
+        if (!time_to_die_)
+            return;
+
+        workload_ = &workload;
+        stats_ = warmup_stats_t {};
+        start_time_ = bench_clock_t::now();
+        bool needs_monitoring = workload_->warmup_duration > 0 || workload_->steady_state_cv > 0;
+        done_.store(!needs_monitoring);
+        if (!needs_monitoring)
+            return;
+
+        time_to_die_ = false;
+        thread_ = std::thread(&warmup_monitor_t::monitor, this);
+    }
+    inline void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (time_to_die_)
+                return;
+            time_to_die_ = true;
+        }
+        condition_.notify_one();
+        thread_.join();
+    }
+
+    /**
+     * @brief Checked by benchmark threads after every warmup operation.
+     */
+    inline bool is_done() const noexcept { return done_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Should be called once all threads have left the warmup.
+     */
+    inline warmup_stats_t const& finish() {
+        stop();
+        stats_.operations_count = progress_->counters().done_iterations;
+        stats_.duration = std::chrono::duration<double>(bench_clock_t::now() - start_time_).count();
+        return stats_;
+    }
+
+  private:
+    void monitor() {
+        std::deque<double> throughputs;
+        size_t last_entries_touched = progress_->counters().entries_touched;
+        time_point_t last_time = start_time_;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                condition_.wait_for(lock, std::chrono::milliseconds(interval_k), [&] { return time_to_die_; });
+                if (time_to_die_)
+                    return;
+            }
+
+            auto now = bench_clock_t::now();
+            size_t entries_touched = progress_->counters().entries_touched;
+            double interval = std::chrono::duration<double>(now - last_time).count();
+            throughputs.push_back((entries_touched - last_entries_touched) / interval);
+            if (throughputs.size() > steady_state_intervals_k)
+                throughputs.pop_front();
+            last_entries_touched = entries_touched;
+            last_time = now;
+
+            double elapsed = std::chrono::duration<double>(now - start_time_).count();
+            if (elapsed < workload_->warmup_duration)
+                continue;
+            if (workload_->steady_state_cv > 0) {
+                stats_.throughput_cv = coefficient_of_variation(throughputs);
+                stats_.steady = throughputs.size() == steady_state_intervals_k &&
+                                stats_.throughput_cv < workload_->steady_state_cv;
+                if (!stats_.steady && elapsed < workload_->steady_state_max_duration)
+                    continue;
+            }
+
+            done_.store(true);
+            return;
+        }
+    }
+
+    static double coefficient_of_variation(std::deque<double> const& values) {
+        if (values.empty())
+            return 0;
+        double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+        if (mean == 0)
+            return 0;
+        double variance = 0;
+        for (double value : values)
+            variance += (value - mean) * (value - mean);
+        variance /= values.size();
+        return std::sqrt(variance) / mean;
+    }
+
+    workload_t const* workload_;
+    progress_t* progress_;
+    std::atomic_bool done_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool time_to_die_;
+
+    time_point_t start_time_;
+    warmup_stats_t stats_;
+};
+
+} // namespace ucsb
@@ -3,22 +3,33 @@
 #include <vector>
 #include <memory>
 #include <utility>
-#include <set>
+#include <algorithm>
+#include <numeric>
+#include <cassert>
 #include <fmt/format.h>
 
 #include "src/core/types.hpp"
+#include "src/core/db.hpp"
 #include "src/core/data_accessor.hpp"
 #include "src/core/workload.hpp"
 #include "src/core/timer.hpp"
 #include "src/core/helper.hpp"
+#include "src/core/trace.hpp"
+#include "src/core/value_pool.hpp"
+#include "src/core/unique_keys.hpp"
 #include "src/core/generators/generator.hpp"
 #include "src/core/generators/const_generator.hpp"
 #include "src/core/generators/counter_generator.hpp"
+#include "src/core/generators/interleaved_counter_generator.hpp"
 #include "src/core/generators/uniform_generator.hpp"
 #include "src/core/generators/zipfian_generator.hpp"
 #include "src/core/generators/scrambled_zipfian_generator.hpp"
 #include "src/core/generators/skewed_zipfian_generator.hpp"
+#include "src/core/generators/hotspot_generator.hpp"
+#include "src/core/generators/exponential_generator.hpp"
+#include "src/core/generators/sequential_generator.hpp"
 #include "src/core/generators/acknowledged_counter_generator.hpp"
+#include "src/core/generators/pregenerated_generator.hpp"
 
 namespace ucsb {
 
@@ -30,13 +41,24 @@ namespace ucsb {
 class worker_t {
   public:
     using key_generator_t = std::unique_ptr<core::generator_gt<key_t>>;
-    using acknowledged_key_generator_t = std::unique_ptr<core::acknowledged_counter_generator_t>;
     using value_length_generator_t = std::unique_ptr<core::generator_gt<value_length_t>>;
-    using value_generator_t = core::random_byte_generator_t;
     using length_generator_t = std::unique_ptr<core::generator_gt<size_t>>;
     using values_and_sizes_spanc_t = std::pair<values_spanc_t, value_lengths_spanc_t>;
 
-    worker_t(workload_t const& workload, data_accessor_t& data_accessor, timer_t& timer);
+    /**
+     * @param streams Random streams of the thread, all generators of the worker are seeded from.
+     * @param frontier Inserted keys, shared with other threads of the workload, unless it's write-only.
+     * @param value_pools Bytes of the written values, shared with other threads and phases.
+     * @param transaction The transaction, operations are done in, if the DB runs in the transactional mode.
+     */
+    worker_t(workload_t const& workload,
+             data_accessor_t& data_accessor,
+             timer_t& timer,
+             core::random_engine_t& streams,
+             core::acknowledged_frontier_t& frontier,
+             value_pools_t& value_pools,
+             size_t thread_idx,
+             transaction_t* transaction);
 
     inline operation_result_t do_upsert();
     inline operation_result_t do_update();
@@ -48,6 +70,34 @@ class worker_t {
     inline operation_result_t do_bulk_load();
     inline operation_result_t do_range_select();
     inline operation_result_t do_scan();
+    /**
+     * @brief Commits the transaction, or rolls it back, if any of its operations failed.
+     * @return `error_k`, if the transaction was aborted.
+     */
+    inline operation_result_t do_commit();
+
+    /**
+     * @brief Counts the done operation towards the current transaction,
+     * if operations are grouped into transactions of the configured length.
+     * @return True, if the transaction is complete and must be committed.
+     */
+    inline bool is_transaction_complete(operation_result_t result) noexcept;
+    /**
+     * @brief Whether some operations were done in the current transaction since the last commit.
+     * It must be finished before the thread waits for others, so it doesn't hold their keys locked.
+     */
+    inline bool is_transaction_pending() const noexcept {
+        return transaction_ && transaction_operations_left_ != transaction_length_;
+    }
+
+    /**
+     * @brief Does the traced operation instead of a generated one.
+     */
+    inline operation_result_t do_replay(trace_record_t const& record);
+    /**
+     * @brief If set, all further operations are appended to the `trace`, without timestamps.
+     */
+    inline void record_trace(trace_records_t* trace) noexcept { trace_ = trace; }
 
   private:
     inline key_generator_t create_key_generator(workload_t const& workload,
@@ -57,27 +107,37 @@ class worker_t {
     inline length_generator_t create_batch_read_length_generator(workload_t const& workload);
     inline length_generator_t create_bulk_load_length_generator(workload_t const& workload);
     inline length_generator_t create_range_select_length_generator(workload_t const& workload);
+    inline length_generator_t create_transaction_length_generator(workload_t const& workload);
+
+    inline size_t pregenerated_keys_count(workload_t const& workload) const noexcept;
 
+    inline key_t fold_key(key_t key, key_t last) const noexcept;
     inline key_t generate_key();
     inline keys_spanc_t generate_batch_upsert_keys();
     inline keys_spanc_t generate_batch_read_keys();
     inline keys_spanc_t generate_bulk_load_keys();
     inline value_spanc_t generate_value();
+    inline value_spanc_t generate_replayed_value(size_t length);
     inline values_and_sizes_spanc_t generate_values(size_t count);
     inline value_span_t value_buffer();
     inline values_span_t values_buffer(size_t count);
+    inline void trace(operation_kind_t kind, key_t key, size_t length = 0);
+    inline void reserve_trace(size_t count);
+    inline void acknowledge(keys_spanc_t keys);
 
     workload_t workload_;
     data_accessor_t* data_accessor_;
     timer_t* timer_;
 
     key_generator_t upsert_key_sequence_generator;
-    acknowledged_key_generator_t acknowledged_key_generator;
+    // Note: Owned by `upsert_key_sequence_generator`, if new keys are shared with other threads
+    core::acknowledged_counter_generator_t* acknowledged_key_generator;
     key_generator_t key_generator_;
     keys_t keys_buffer_;
+    unique_keys_t unique_keys_;
 
     value_length_generator_t value_length_generator_;
-    value_generator_t value_generator_;
+    value_cursor_t value_cursor_;
     values_buffer_t values_buffer_;
     value_lengths_t value_sizes_buffer_;
 
@@ -85,19 +145,49 @@ class worker_t {
     length_generator_t batch_read_length_generator_;
     length_generator_t bulk_load_length_generator_;
     length_generator_t range_select_length_generator_;
+
+    // Note: Set only if operations are grouped into transactions of the configured length
+    transaction_t* transaction_;
+    length_generator_t transaction_length_generator_;
+    size_t transaction_length_;
+    size_t transaction_operations_left_;
+    bool is_transaction_failed_;
+    core::random_engine_t conflict_engine_;
+    key_generator_t conflict_key_generator_;
+
+    trace_records_t* trace_;
 };
 
-worker_t::worker_t(workload_t const& workload, data_accessor_t& data_accessor, timer_t& timer)
-    : workload_(workload), data_accessor_(&data_accessor), timer_(&timer) {
+worker_t::worker_t(workload_t const& workload,
+                   data_accessor_t& data_accessor,
+                   timer_t& timer,
+                   core::random_engine_t& streams,
+                   core::acknowledged_frontier_t& frontier,
+                   value_pools_t& value_pools,
+                   size_t thread_idx,
+                   transaction_t* transaction)
+    : workload_(workload), data_accessor_(&data_accessor), timer_(&timer), acknowledged_key_generator(nullptr),
+      transaction_(nullptr), transaction_length_(0), transaction_operations_left_(0), is_transaction_failed_(false),
+      trace_(nullptr) {
 
     if (workload.upsert_proportion == 1.0 || workload.batch_upsert_proportion == 1.0 ||
-        workload.bulk_load_proportion == 1.0)
-        upsert_key_sequence_generator = std::make_unique<core::counter_generator_t>(workload.start_key);
+        workload.bulk_load_proportion == 1.0) {
+        if (workload.upsert_keys_stride)
+            upsert_key_sequence_generator = std::make_unique<core::interleaved_counter_generator_t>(
+                workload.start_key,
+                workload.upsert_keys_stride);
+        else
+            upsert_key_sequence_generator = std::make_unique<core::counter_generator_t>(workload.start_key);
+    }
     else {
-        acknowledged_key_generator =
-            std::make_unique<core::acknowledged_counter_generator_t>(workload.db_records_count);
+        auto generator = std::make_unique<core::acknowledged_counter_generator_t>(frontier, thread_idx);
+        acknowledged_key_generator = generator.get();
+        upsert_key_sequence_generator = std::move(generator);
         key_generator_ = create_key_generator(workload, *acknowledged_key_generator);
-        upsert_key_sequence_generator = std::move(acknowledged_key_generator);
+        key_generator_->seed(streams);
+        if (workload.pregenerate_keys)
+            key_generator_ = std::make_unique<core::pregenerated_generator_t>(std::move(key_generator_),
+                                                                              pregenerated_keys_count(workload));
     }
     size_t elements_max_count = std::max({workload.batch_upsert_max_length,
                                           workload.batch_read_max_length,
@@ -105,8 +195,12 @@ worker_t::worker_t(workload_t const& workload, data_accessor_t& data_accessor, t
                                           workload.range_select_max_length,
                                           size_t(1)});
     keys_buffer_ = keys_t(elements_max_count);
+    if (workload.batch_read_proportion > 0 && workload.batch_read_unique_keys)
+        unique_keys_ = unique_keys_t(workload.batch_read_max_length);
 
     value_length_generator_ = create_value_length_generator(workload);
+    value_length_generator_->seed(streams);
+    value_cursor_ = value_cursor_t(value_pools.pool(workload_, elements_max_count * workload_.value_length), streams);
     size_t value_aligned_length = roundup_to_multiple<values_buffer_t::alignment_k>(workload_.value_length);
     values_buffer_ = values_buffer_t(elements_max_count * value_aligned_length);
     value_sizes_buffer_ = value_lengths_t(elements_max_count, 0);
@@ -115,11 +209,30 @@ worker_t::worker_t(workload_t const& workload, data_accessor_t& data_accessor, t
     batch_read_length_generator_ = create_batch_read_length_generator(workload);
     bulk_load_length_generator_ = create_bulk_load_length_generator(workload);
     range_select_length_generator_ = create_range_select_length_generator(workload);
+    batch_upsert_length_generator_->seed(streams);
+    batch_read_length_generator_->seed(streams);
+    bulk_load_length_generator_->seed(streams);
+    range_select_length_generator_->seed(streams);
+
+    if (transaction && workload.transaction_max_length) {
+        transaction_ = transaction;
+        transaction_length_generator_ = create_transaction_length_generator(workload);
+        transaction_length_generator_->seed(streams);
+        transaction_length_ = transaction_length_generator_->generate();
+        transaction_operations_left_ = transaction_length_;
+        if (workload.transaction_conflict_proportion > 0) {
+            conflict_engine_ = streams.split();
+            conflict_key_generator_ = std::make_unique<core::uniform_generator_gt<key_t>>(
+                workload.db_start_key, workload.db_start_key + workload.transaction_conflict_keys_count - 1);
+            conflict_key_generator_->seed(streams);
+        }
+    }
 }
 
 inline operation_result_t worker_t::do_upsert() {
     key_t key = upsert_key_sequence_generator->generate();
     value_spanc_t value = generate_value();
+    trace(operation_kind_t::upsert_k, key, value.size());
     auto status = data_accessor_->upsert(key, value);
     if (acknowledged_key_generator)
         acknowledged_key_generator->acknowledge(key);
@@ -129,16 +242,19 @@ inline operation_result_t worker_t::do_upsert() {
 inline operation_result_t worker_t::do_update() {
     key_t key = generate_key();
     value_spanc_t value = generate_value();
+    trace(operation_kind_t::update_k, key, value.size());
     return data_accessor_->update(key, value);
 }
 
 inline operation_result_t worker_t::do_remove() {
     key_t key = generate_key();
+    trace(operation_kind_t::remove_k, key);
     return data_accessor_->remove(key);
 }
 
 inline operation_result_t worker_t::do_read() {
     key_t key = generate_key();
+    trace(operation_kind_t::read_k, key);
     value_span_t value = value_buffer();
     return data_accessor_->read(key, value);
 }
@@ -149,6 +265,7 @@ inline operation_result_t worker_t::do_read_modify_write() {
     data_accessor_->read(key, read_value);
 
     value_spanc_t value = generate_value();
+    trace(operation_kind_t::read_modify_write_k, key, value.size());
     return data_accessor_->update(key, value);
 }
 
@@ -157,9 +274,14 @@ inline operation_result_t worker_t::do_batch_upsert() {
     timer_->pause();
     keys_spanc_t keys = generate_batch_upsert_keys();
     values_and_sizes_spanc_t values_and_sizes = generate_values(keys.size());
+    reserve_trace(keys.size());
+    for (size_t i = 0; trace_ && i < keys.size(); ++i)
+        trace(operation_kind_t::upsert_k, keys[i], values_and_sizes.second[i]);
     timer_->resume();
 
-    return data_accessor_->batch_upsert(keys, values_and_sizes.first, values_and_sizes.second);
+    auto status = data_accessor_->batch_upsert(keys, values_and_sizes.first, values_and_sizes.second);
+    acknowledge(keys);
+    return status;
 }
 
 inline operation_result_t worker_t::do_batch_read() {
@@ -167,6 +289,9 @@ inline operation_result_t worker_t::do_batch_read() {
     timer_->pause();
     keys_spanc_t keys = generate_batch_read_keys();
     values_span_t values = values_buffer(keys.size());
+    reserve_trace(keys.size());
+    for (size_t i = 0; trace_ && i < keys.size(); ++i)
+        trace(operation_kind_t::read_k, keys[i]);
     timer_->resume();
     return data_accessor_->batch_read(keys, values);
 }
@@ -176,23 +301,78 @@ inline operation_result_t worker_t::do_bulk_load() {
     timer_->pause();
     keys_spanc_t keys = generate_bulk_load_keys();
     values_and_sizes_spanc_t values_and_sizes = generate_values(keys.size());
+    reserve_trace(keys.size());
+    for (size_t i = 0; trace_ && i < keys.size(); ++i)
+        trace(operation_kind_t::upsert_k, keys[i], values_and_sizes.second[i]);
     timer_->resume();
 
-    return data_accessor_->bulk_load(keys, values_and_sizes.first, values_and_sizes.second);
+    auto status = data_accessor_->bulk_load(keys, values_and_sizes.first, values_and_sizes.second);
+    acknowledge(keys);
+    return status;
 }
 
 inline operation_result_t worker_t::do_range_select() {
     key_t key = generate_key();
     size_t length = range_select_length_generator_->generate();
+    trace(operation_kind_t::range_select_k, key, length);
     values_span_t values = values_buffer(length);
     return data_accessor_->range_select(key, length, values);
 }
 
 inline operation_result_t worker_t::do_scan() {
     value_span_t single_value = value_buffer();
+    trace(operation_kind_t::scan_k, workload_.start_key, workload_.records_count);
     return data_accessor_->scan(workload_.start_key, workload_.records_count, single_value);
 }
 
+inline operation_result_t worker_t::do_commit() {
+    transaction_length_ = transaction_length_generator_->generate();
+    transaction_operations_left_ = transaction_length_;
+    if (!is_transaction_failed_)
+        return transaction_->commit();
+
+    is_transaction_failed_ = false;
+    transaction_->rollback();
+    return {0, operation_status_t::error_k};
+}
+
+inline bool worker_t::is_transaction_complete(operation_result_t result) noexcept {
+    if (!transaction_)
+        return false;
+    // Note: Missing keys are expected, but errors, like conflicting locks, doom the transaction
+    is_transaction_failed_ |= result.status == operation_status_t::error_k;
+    return !--transaction_operations_left_;
+}
+
+inline operation_result_t worker_t::do_replay(trace_record_t const& record) {
+    key_t key = record.key;
+    switch (operation_kind_t(record.kind)) {
+    case operation_kind_t::upsert_k: {
+        value_spanc_t value = generate_replayed_value(record.length);
+        return data_accessor_->upsert(key, value);
+    }
+    case operation_kind_t::update_k: {
+        value_spanc_t value = generate_replayed_value(record.length);
+        return data_accessor_->update(key, value);
+    }
+    case operation_kind_t::remove_k: return data_accessor_->remove(key);
+    case operation_kind_t::read_k: return data_accessor_->read(key, value_buffer());
+    case operation_kind_t::read_modify_write_k: {
+        value_span_t read_value = value_buffer();
+        data_accessor_->read(key, read_value);
+        value_spanc_t value = generate_replayed_value(record.length);
+        return data_accessor_->update(key, value);
+    }
+    case operation_kind_t::range_select_k: {
+        // Note: Ranges are limited by the preallocated buffers
+        size_t length = std::min<size_t>(record.length, keys_buffer_.size());
+        return data_accessor_->range_select(key, length, values_buffer(length));
+    }
+    case operation_kind_t::scan_k: return data_accessor_->scan(key, record.length, value_buffer());
+    default: throw exception_t(fmt::format("Unsupported traced operation: {}", int(record.kind)));
+    }
+}
+
 inline worker_t::key_generator_t worker_t::create_key_generator(workload_t const& workload,
                                                                 core::counter_generator_t& counter_generator) {
     key_generator_t generator;
@@ -203,6 +383,11 @@ inline worker_t::key_generator_t worker_t::create_key_generator(workload_t const
                                                                 workload.start_key + workload.records_count - 1);
         break;
     case distribution_kind_t::zipfian_k: {
+        // Note: Without the operations limit, the range follows the inserted keys
+        if (!workload.operations_count) {
+            generator = std::make_unique<core::scrambled_zipfian_generator_t>(workload.start_key, counter_generator);
+            break;
+        }
         size_t new_keys = (size_t)(workload.operations_count * workload.upsert_proportion * 2);
         generator = std::make_unique<core::scrambled_zipfian_generator_t>(workload.start_key,
                                                                           workload.start_key + workload.records_count +
@@ -212,6 +397,24 @@ inline worker_t::key_generator_t worker_t::create_key_generator(workload_t const
     case distribution_kind_t::skewed_latest_k:
         generator = std::make_unique<core::skewed_latest_generator_t>(counter_generator);
         break;
+    case distribution_kind_t::hotspot_k:
+        generator = std::make_unique<core::hotspot_generator_t>(workload.start_key,
+                                                                workload.start_key + workload.records_count - 1,
+                                                                workload.hotspot_set_fraction,
+                                                                workload.hotspot_operations_fraction,
+                                                                workload.hotspot_shift_rate);
+        break;
+    case distribution_kind_t::exponential_k:
+        generator = std::make_unique<core::exponential_generator_t>(workload.start_key,
+                                                                    workload.records_count,
+                                                                    workload.exponential_percentile,
+                                                                    workload.exponential_range_fraction,
+                                                                    counter_generator);
+        break;
+    case distribution_kind_t::sequential_k:
+        generator = std::make_unique<core::sequential_generator_t>(workload.start_key,
+                                                                   workload.start_key + workload.records_count - 1);
+        break;
     default: throw exception_t(fmt::format("Unknown key distribution: {}", int(workload.key_dist)));
     }
     return generator;
@@ -307,53 +510,84 @@ inline worker_t::length_generator_t worker_t::create_range_select_length_generat
     return generator;
 }
 
+inline worker_t::length_generator_t worker_t::create_transaction_length_generator(workload_t const& workload) {
+
+    length_generator_t generator;
+    switch (workload.transaction_length_dist) {
+    case distribution_kind_t::uniform_k:
+        generator = std::make_unique<core::uniform_generator_gt<size_t>>(workload.transaction_min_length,
+                                                                         workload.transaction_max_length);
+        break;
+    case distribution_kind_t::zipfian_k:
+        generator = std::make_unique<core::zipfian_generator_t>(workload.transaction_min_length,
+                                                                workload.transaction_max_length);
+        break;
+    default:
+        throw exception_t(
+            fmt::format("Unknown transaction length distribution: {}", int(workload.transaction_length_dist)));
+    }
+    return generator;
+}
+
+inline size_t worker_t::pregenerated_keys_count(workload_t const& workload) const noexcept {
+    // Note: Without the operations limit, the sequence is repeated once exhausted,
+    // so a longer buffer only costs memory, 8 MB per thread per phase at most
+    constexpr size_t max_count_k = size_t(1) << 20;
+    if (!workload.operations_count)
+        return max_count_k;
+    double keys_per_operation = 1.0 + workload.batch_read_proportion * workload.batch_read_max_length;
+    size_t operations_count = workload.operations_count + workload.warmup_operations_count;
+    return std::min(size_t(operations_count * keys_per_operation) + 1, max_count_k);
+}
+
+/**
+ * @brief Keys past the last acknowledged insert are folded back into the inserted range,
+ * instead of being drawn again, so every key takes exactly one sample.
+ */
+inline key_t worker_t::fold_key(key_t key, key_t last) const noexcept {
+    assert(last >= workload_.start_key);
+    return key <= last ? key : workload_.start_key + (key - workload_.start_key) % (last - workload_.start_key + 1);
+}
+
 inline key_t worker_t::generate_key() {
-    key_t key = 0;
-    do {
-        key = key_generator_->generate();
-    } while (key > upsert_key_sequence_generator->last());
-    return key;
+    // Note: Keys common to all threads make their transactions conflict
+    if (conflict_key_generator_ && conflict_engine_.next_double() < workload_.transaction_conflict_proportion)
+        return conflict_key_generator_->generate();
+    return fold_key(key_generator_->generate(), upsert_key_sequence_generator->last());
 }
 
 inline keys_spanc_t worker_t::generate_batch_upsert_keys() {
     size_t batch_length = batch_upsert_length_generator_->generate();
     keys_span_t keys(keys_buffer_.data(), batch_length);
-    for (size_t i = 0; i < batch_length; ++i) {
-        key_t key = upsert_key_sequence_generator->generate();
-        keys[i] = key;
-        if (acknowledged_key_generator)
-            acknowledged_key_generator->acknowledge(key);
-    }
-
+    upsert_key_sequence_generator->generate_batch(keys);
     return keys;
 }
 
 inline keys_spanc_t worker_t::generate_batch_read_keys() {
     size_t batch_length = batch_read_length_generator_->generate();
     keys_span_t keys(keys_buffer_.data(), batch_length);
-    size_t unique_keys_count = 0;
-    std::set<key_t> unique_keys;
-    while (unique_keys_count != batch_length) {
-        auto key = generate_key();
-        if (!unique_keys.contains(key)) {
-            keys[unique_keys_count] = key;
-            unique_keys_count++;
-            unique_keys.insert(key);
+    size_t accepted_keys_count = 0;
+    unique_keys_.clear();
+    key_t const last_key = upsert_key_sequence_generator->last();
+    // Note: Candidates are generated in batches, and the repeated ones are replaced by the next batch
+    while (accepted_keys_count != batch_length) {
+        keys_span_t candidates = keys.subspan(accepted_keys_count);
+        key_generator_->generate_batch(candidates);
+        for (size_t i = 0; i != candidates.size(); ++i) {
+            key_t key = fold_key(candidates[i], last_key);
+            if (!workload_.batch_read_unique_keys || unique_keys_.insert(key))
+                keys[accepted_keys_count++] = key;
         }
     }
+    if (workload_.batch_read_sorted_keys)
+        std::sort(keys.begin(), keys.end());
     return keys;
 }
 
 inline keys_spanc_t worker_t::generate_bulk_load_keys() {
     size_t bulk_length = bulk_load_length_generator_->generate();
     keys_span_t keys(keys_buffer_.data(), bulk_length);
-    for (size_t i = 0; i < bulk_length; ++i) {
-        key_t key = upsert_key_sequence_generator->generate();
-        keys[i] = key;
-        if (acknowledged_key_generator)
-            acknowledged_key_generator->acknowledge(key);
-    }
-
+    upsert_key_sequence_generator->generate_batch(keys);
     return keys;
 }
 
@@ -362,22 +596,55 @@ inline value_spanc_t worker_t::generate_value() {
     return value_spanc_t {value_and_size.first.data(), value_and_size.second.front()};
 }
 
+/**
+ * @brief A value of the traced length, or of the workload length, if the trace has none.
+ * It's never longer than the generated value, which may be shorter with variable lengths.
+ */
+inline value_spanc_t worker_t::generate_replayed_value(size_t length) {
+    value_spanc_t value = generate_value();
+    return value.first(std::min<size_t>(length ? length : workload_.value_length, value.size()));
+}
+
 inline worker_t::values_and_sizes_spanc_t worker_t::generate_values(size_t count) {
-    for (size_t i = 0; i < count * workload_.value_length; ++i)
-        values_buffer_[i] = std::byte(value_generator_.generate());
-
-    size_t total_length = 0;
-    for (size_t i = 0; i < count; ++i) {
-        value_length_t length = value_length_generator_->generate();
-        value_sizes_buffer_[i] = length;
-        total_length += length;
-    }
-    return std::make_pair(values_spanc_t(values_buffer_.data(), total_length),
-                          value_lengths_spanc_t(value_sizes_buffer_.data(), count));
+    value_lengths_span_t lengths(value_sizes_buffer_.data(), count);
+    value_length_generator_->generate_batch(lengths);
+    size_t total_length = std::accumulate(lengths.begin(), lengths.end(), size_t(0));
+    return std::make_pair(value_cursor_.take(total_length), value_lengths_spanc_t(value_sizes_buffer_.data(), count));
 }
 
 inline value_span_t worker_t::value_buffer() { return values_buffer(1); }
 
+inline void worker_t::trace(operation_kind_t kind, key_t key, size_t length) {
+    if (!trace_)
+        return;
+    // Note: Pause benchmark timer to grow the trace, to measure the operation time only
+    if (trace_->size() == trace_->capacity()) {
+        timer_->pause();
+        reserve_trace(1);
+        timer_->resume();
+    }
+    trace_->push_back(trace_record_t {key, 0, uint32_t(length), uint8_t(kind)});
+}
+
+inline void worker_t::reserve_trace(size_t count) {
+    constexpr size_t min_capacity_k = size_t(1) << 16;
+    if (!trace_ || trace_->size() + count <= trace_->capacity())
+        return;
+    trace_->reserve(std::max({trace_->capacity() * 2, trace_->size() + count, min_capacity_k}));
+}
+
+/**
+ * @brief Makes the written keys visible to readers of all threads.
+ */
+inline void worker_t::acknowledge(keys_spanc_t keys) {
+    if (!acknowledged_key_generator)
+        return;
+    timer_->pause();
+    for (key_t key : keys)
+        acknowledged_key_generator->acknowledge(key);
+    timer_->resume();
+}
+
 inline values_span_t worker_t::values_buffer(size_t count) {
     size_t value_aligned_length = roundup_to_multiple<values_buffer_t::alignment_k>(workload_.value_length);
     size_t total_length = count * value_aligned_length;
@@ -5,15 +5,30 @@
 #include <cstddef>
 #include <fstream>
 
+#include <fmt/format.h>
 #include <nlohmann/json.hpp>
 
 #include "src/core/types.hpp"
 #include "src/core/distribution.hpp"
+#include "src/core/key_encoding.hpp"
 
 using json = nlohmann::json;
 
 namespace ucsb {
 
+/**
+ * @brief Shape of the generated values, which defines how well they compress.
+ */
+enum class value_profile_t {
+    unknown_k,
+
+    printable_k,   // Random printable characters
+    random_k,      // Random bytes, with fragments repeated to match the compressibility
+    text_k,        // Words of a small vocabulary
+    zero_padded_k, // Random bytes, padded with zeros to match the compressibility
+    json_k,        // Documents of a repeated JSON template
+};
+
 /**
  * @brief A description of a single benchmark.
  * It's post-processed version will divide the task
@@ -44,6 +59,74 @@ struct workload_t {
      * which will be done by a single thread, divided by the number of threads.
      */
     size_t operations_count = 0;
+    /**
+     * @brief If set, all threads run until a shared deadline, this many seconds
+     * after the start, and the operations are counted dynamically.
+     * The operations count, if also set, remains an upper bound.
+     */
+    double duration = 0;
+    /**
+     * @brief Set for write-only workloads bounded by time, or with a time-based warmup,
+     * where the number of new keys per thread isn't known in advance. Instead of a contiguous range,
+     * the thread inserts chunks of keys, which are this many keys apart. Zero means a contiguous range.
+     */
+    size_t upsert_keys_stride = 0;
+    /**
+     * @brief Target throughput of all threads in operations per second.
+     * Zero means a closed loop, where every thread issues the next operation
+     * as soon as the previous one completes. Otherwise operations are issued
+     * in an open loop on a fixed schedule.
+     */
+    double db_operations_per_second = 0;
+    /**
+     * @brief Target throughput for this specific workload,
+     * which will be sustained by a single thread, divided by the number of threads.
+     */
+    double operations_per_second = 0;
+
+    /**
+     * @brief If set, operations are replayed from this binary trace,
+     * instead of being generated from the proportions and distributions below.
+     */
+    std::string trace_path;
+    /**
+     * @brief If set, the text access log is imported into `trace_path` before the replay.
+     * @see `import_trace()` for the format.
+     */
+    std::string trace_import_path;
+    /**
+     * @brief Replays trace operations at their recorded timestamps, instead of as fast as possible.
+     */
+    bool trace_paced = false;
+    /**
+     * @brief If set, the operations done by all threads are recorded into this binary trace.
+     */
+    std::string record_trace_path;
+
+    /**
+     * @brief Number of operations done by all threads before the measurements start.
+     * Their results are discarded, they only warm up caches, memtables, etc.
+     */
+    size_t db_warmup_operations_count = 0;
+    /**
+     * @brief Number of warmup operations for this specific workload,
+     * which will be done by a single thread, divided by the number of threads.
+     */
+    size_t warmup_operations_count = 0;
+    /**
+     * @brief Minimal warmup duration in seconds.
+     */
+    double warmup_duration = 0;
+    /**
+     * @brief If set, the warmup continues until the coefficient of variation
+     * of the throughput measured over short intervals drops below this value,
+     * meaning the DB has reached a steady state.
+     */
+    double steady_state_cv = 0;
+    /**
+     * @brief The limit of the warmup duration in seconds, if the steady state isn't reached.
+     */
+    double steady_state_max_duration = 60;
 
     float upsert_proportion = 0;
     float update_proportion = 0;
@@ -56,11 +139,54 @@ struct workload_t {
     float range_select_proportion = 0;
     float scan_proportion = 0;
 
+    /**
+     * @brief The first key of the whole workload. Unlike `start_key`, it isn't moved
+     * to the range of a specific thread, so new keys are inserted right after the range.
+     */
+    key_t db_start_key = 0;
     key_t start_key = 0;
     distribution_kind_t key_dist = distribution_kind_t::uniform_k;
+    /**
+     * @brief Parameters of the `hotspot` key distribution: `hotspot_operations_fraction` of operations
+     * access `hotspot_set_fraction` of keys. After every operation of a thread, the hot set moves
+     * forward by `hotspot_shift_rate` keys, so a non-zero rate makes the working set drift.
+     */
+    double hotspot_set_fraction = 0.2;
+    double hotspot_operations_fraction = 0.8;
+    double hotspot_shift_rate = 0;
+    /**
+     * @brief Parameters of the `exponential` key distribution:
+     * `exponential_percentile` percent of operations access the latest `exponential_range_fraction` of keys,
+     * counted back from the last inserted key.
+     */
+    double exponential_percentile = 95;
+    double exponential_range_fraction = 0.8571;
+    /**
+     * @brief How keys are stored in the DB. It's the format of the DB itself,
+     * so all the workloads of a single run must share it.
+     */
+    key_encoding_t key_encoding;
+    /**
+     * @brief If set, every thread materializes its key sequence before the benchmark starts,
+     * so key generation isn't measured as the DB time. Distributions following the inserted
+     * keys, `skewed_latest`, `exponential` and `zipfian` without the operations count, can't be pregenerated.
+     */
+    bool pregenerate_keys = false;
+    /**
+     * @brief Seed of all random generators. Every thread derives independent streams from it,
+     * so runs with the same seed and threads count generate the same operations.
+     */
+    size_t seed = 0;
 
     value_length_t value_length = 0;
     distribution_kind_t value_length_dist = distribution_kind_t::const_k;
+    value_profile_t value_profile = value_profile_t::printable_k;
+    /**
+     * @brief Target ratio of the original to the compressed values size.
+     * Only the `random` and `zero_padded` profiles are tuned to it,
+     * text and JSON values compress as much as their structure allows.
+     */
+    double value_compressibility = 1.0;
 
     size_t batch_upsert_min_length = 0;
     size_t batch_upsert_max_length = 0;
@@ -69,6 +195,13 @@ struct workload_t {
     size_t batch_read_min_length = 0;
     size_t batch_read_max_length = 0;
     distribution_kind_t batch_read_length_dist = distribution_kind_t::uniform_k;
+    /**
+     * @brief Batch reads may repeat keys only if `batch_read_unique_keys` is unset,
+     * and are submitted in ascending key order if `batch_read_sorted_keys` is set,
+     * to measure how much batched lookups benefit from key locality.
+     */
+    bool batch_read_unique_keys = true;
+    bool batch_read_sorted_keys = false;
 
     size_t bulk_load_min_length = 0;
     size_t bulk_load_max_length = 0;
@@ -77,6 +210,39 @@ struct workload_t {
     size_t range_select_min_length = 0;
     size_t range_select_max_length = 0;
     distribution_kind_t range_select_length_dist = distribution_kind_t::uniform_k;
+
+    /**
+     * @brief In the transactional mode, operations of every thread are grouped into transactions
+     * of this many operations, each committed or aborted on its own. Unless set,
+     * a single transaction spans the whole workload.
+     */
+    size_t transaction_min_length = 0;
+    size_t transaction_max_length = 0;
+    distribution_kind_t transaction_length_dist = distribution_kind_t::uniform_k;
+    /**
+     * @brief The share of keys in transactions, which are drawn from a small set of keys
+     * at the start of the range, common to all threads, so transactions conflict.
+     */
+    float transaction_conflict_proportion = 0;
+    size_t transaction_conflict_keys_count = 16;
+
+    /**
+     * @brief Consecutive stages of the workload, run in a single DB session without reopening it.
+     * Every phase inherits all fields of the workload and overrides some of them, like proportions,
+     * key distribution, value length and duration. If empty, the workload itself is the only phase.
+     */
+    std::vector<workload_t> phases;
+    /**
+     * @brief Groups of threads running concurrently against the same DB, each with its own mix,
+     * key range, distribution and rate limit. Every tenant inherits all fields of the workload
+     * and overrides some of them. Tenants inserting new keys must leave a gap after their ranges.
+     */
+    std::vector<workload_t> tenants;
+    /**
+     * @brief The name of the tenant and the number of its threads, set only for tenants.
+     */
+    std::string tenant;
+    size_t threads_count = 0;
 };
 
 using workloads_t = std::vector<workload_t>;
@@ -97,9 +263,142 @@ inline distribution_kind_t parse_distribution(std::string const& name) {
         dist = distribution_kind_t::skewed_latest_k;
     else if (name == "acknowledged")
         dist = distribution_kind_t::acknowledged_counter_k;
+    else if (name == "hotspot")
+        dist = distribution_kind_t::hotspot_k;
+    else if (name == "exponential")
+        dist = distribution_kind_t::exponential_k;
+    else if (name == "sequential")
+        dist = distribution_kind_t::sequential_k;
     return dist;
 }
 
+inline value_profile_t parse_value_profile(std::string const& name) {
+    value_profile_t profile = value_profile_t::unknown_k;
+    if (name == "printable")
+        profile = value_profile_t::printable_k;
+    else if (name == "random")
+        profile = value_profile_t::random_k;
+    else if (name == "text")
+        profile = value_profile_t::text_k;
+    else if (name == "zero_padded")
+        profile = value_profile_t::zero_padded_k;
+    else if (name == "json")
+        profile = value_profile_t::json_k;
+    return profile;
+}
+
+/**
+ * @brief Parses a single workload, without its phases.
+ */
+inline bool parse_workload(json const& j_workload, workload_t& workload) {
+
+    workload.name = j_workload["name"].get<std::string>();
+
+    workload.db_records_count = j_workload["records_count"].get<size_t>();
+    workload.db_operations_count = j_workload.value("operations_count", size_t(0));
+    workload.duration = j_workload.value("duration_seconds", 0.0);
+    workload.db_operations_per_second = j_workload.value("operations_per_second", 0.0);
+
+    workload.trace_path = j_workload.value("trace_path", "");
+    workload.trace_import_path = j_workload.value("trace_import_path", "");
+    workload.trace_paced = j_workload.value("trace_paced", false);
+    workload.record_trace_path = j_workload.value("record_trace_path", "");
+
+    workload.db_warmup_operations_count = j_workload.value("warmup_operations_count", size_t(0));
+    workload.warmup_duration = j_workload.value("warmup_seconds", 0.0);
+    workload.steady_state_cv = j_workload.value("steady_state_cv", 0.0);
+    workload.steady_state_max_duration = j_workload.value("steady_state_max_seconds", 60.0);
+
+    workload.upsert_proportion = j_workload.value("upsert_proportion", 0.0);
+    workload.update_proportion = j_workload.value("update_proportion", 0.0);
+    workload.remove_proportion = j_workload.value("remove_proportion", 0.0);
+    workload.read_proportion = j_workload.value("read_proportion", 0.0);
+    workload.read_modify_write_proportion = j_workload.value("read_modify_write_proportion", 0.0);
+    workload.batch_upsert_proportion = j_workload.value("batch_upsert_proportion", 0.0);
+    workload.batch_read_proportion = j_workload.value("batch_read_proportion", 0.0);
+    workload.bulk_load_proportion = j_workload.value("bulk_load_proportion", 0.0);
+    workload.range_select_proportion = j_workload.value("range_select_proportion", 0.0);
+    workload.scan_proportion = j_workload.value("scan_proportion", 0.0);
+
+    workload.start_key = j_workload.value("start_key", key_t(0));
+    workload.db_start_key = workload.start_key;
+    workload.key_dist = parse_distribution(j_workload.value("key_dist", "uniform"));
+    if (workload.key_dist == distribution_kind_t::unknown_k)
+        return false;
+    workload.hotspot_set_fraction = j_workload.value("hotspot_set_fraction", 0.2);
+    workload.hotspot_operations_fraction = j_workload.value("hotspot_operations_fraction", 0.8);
+    workload.hotspot_shift_rate = j_workload.value("hotspot_shift_rate", 0.0);
+    workload.exponential_percentile = j_workload.value("exponential_percentile", 95.0);
+    workload.exponential_range_fraction = j_workload.value("exponential_range_fraction", 0.8571);
+    workload.key_encoding.format = parse_key_format(j_workload.value("key_format", "fixed"));
+    workload.key_encoding.prefix = j_workload.value("key_prefix", "");
+    workload.key_encoding.min_length = j_workload.value("key_min_length", size_t(0));
+    workload.key_encoding.max_length = j_workload.value("key_max_length", workload.key_encoding.min_length);
+    workload.key_encoding.length_dist = parse_distribution(j_workload.value("key_length_dist", "uniform"));
+    if (workload.key_encoding.format == key_format_t::unknown_k ||
+        (workload.key_encoding.length_dist != distribution_kind_t::uniform_k &&
+         workload.key_encoding.length_dist != distribution_kind_t::const_k))
+        return false;
+    workload.pregenerate_keys = j_workload.value("pregenerate_keys", false);
+    workload.seed = j_workload.value("seed", size_t(0));
+
+    workload.value_length = j_workload.value("value_length", value_length_t(0));
+    workload.value_length_dist = parse_distribution(j_workload.value("value_length_dist", "const"));
+    if (workload.value_length_dist == distribution_kind_t::unknown_k)
+        return false;
+    workload.value_profile = parse_value_profile(j_workload.value("value_profile", "printable"));
+    if (workload.value_profile == value_profile_t::unknown_k)
+        return false;
+    workload.value_compressibility = j_workload.value("value_compressibility", 1.0);
+
+    workload.batch_upsert_min_length = j_workload.value("batch_upsert_min_length", size_t(0));
+    workload.batch_upsert_max_length = j_workload.value("batch_upsert_max_length", size_t(0));
+    workload.batch_upsert_length_dist = parse_distribution(j_workload.value("batch_upsert_length_dist", "uniform"));
+    if (workload.batch_upsert_length_dist == distribution_kind_t::unknown_k)
+        return false;
+
+    workload.batch_read_min_length = j_workload.value("batch_read_min_length", size_t(0));
+    workload.batch_read_max_length = j_workload.value("batch_read_max_length", size_t(0));
+    workload.batch_read_length_dist = parse_distribution(j_workload.value("batch_read_length_dist", "uniform"));
+    if (workload.batch_read_length_dist == distribution_kind_t::unknown_k)
+        return false;
+    workload.batch_read_unique_keys = j_workload.value("batch_read_unique_keys", true);
+    workload.batch_read_sorted_keys = j_workload.value("batch_read_sorted_keys", false);
+
+    workload.bulk_load_min_length = j_workload.value("bulk_load_min_length", size_t(0));
+    workload.bulk_load_max_length = j_workload.value("bulk_load_max_length", size_t(0));
+    workload.bulk_load_length_dist = parse_distribution(j_workload.value("bulk_load_length_dist", "uniform"));
+    if (workload.bulk_load_length_dist == distribution_kind_t::unknown_k)
+        return false;
+
+    workload.range_select_min_length = j_workload.value("range_select_min_length", size_t(0));
+    workload.range_select_max_length = j_workload.value("range_select_max_length", size_t(0));
+    workload.range_select_length_dist = parse_distribution(j_workload.value("range_select_length_dist", "uniform"));
+    if (workload.key_dist == distribution_kind_t::unknown_k)
+        return false;
+
+    workload.transaction_min_length = j_workload.value("transaction_min_length", size_t(0));
+    workload.transaction_max_length = j_workload.value("transaction_max_length", size_t(0));
+    workload.transaction_length_dist = parse_distribution(j_workload.value("transaction_length_dist", "uniform"));
+    if (workload.transaction_length_dist == distribution_kind_t::unknown_k)
+        return false;
+    workload.transaction_conflict_proportion = j_workload.value("transaction_conflict_proportion", 0.0);
+    workload.transaction_conflict_keys_count = j_workload.value("transaction_conflict_keys_count", size_t(16));
+
+    return true;
+}
+
+/**
+ * @brief Parses a phase or a tenant, which inherits all fields of its workload and overrides some of them.
+ */
+inline bool parse_nested_workload(json const& j_workload, json const& j_nested, workload_t& nested) {
+    json j_merged = j_workload;
+    j_merged.erase("phases");
+    j_merged.erase("tenants");
+    j_merged.update(j_nested);
+    return parse_workload(j_merged, nested);
+}
+
 bool load(fs::path const& path, workloads_t& workloads) {
 
     workloads.clear();
@@ -110,71 +409,36 @@ bool load(fs::path const& path, workloads_t& workloads) {
     json j_workloads;
     ifstream >> j_workloads;
 
-    for (auto j_workload = j_workloads.begin(); j_workload != j_workloads.end(); ++j_workload) {
+    for (auto const& j_workload : j_workloads) {
         workload_t workload;
-
-        workload.name = (*j_workload)["name"].get<std::string>();
-
-        workload.db_records_count = (*j_workload)["records_count"].get<size_t>();
-        workload.db_operations_count = (*j_workload)["operations_count"].get<size_t>();
-
-        workload.upsert_proportion = (*j_workload).value("upsert_proportion", 0.0);
-        workload.update_proportion = (*j_workload).value("update_proportion", 0.0);
-        workload.remove_proportion = (*j_workload).value("remove_proportion", 0.0);
-        workload.read_proportion = (*j_workload).value("read_proportion", 0.0);
-        workload.read_modify_write_proportion = (*j_workload).value("read_modify_write_proportion", 0.0);
-        workload.batch_upsert_proportion = (*j_workload).value("batch_upsert_proportion", 0.0);
-        workload.batch_read_proportion = (*j_workload).value("batch_read_proportion", 0.0);
-        workload.bulk_load_proportion = (*j_workload).value("bulk_load_proportion", 0.0);
-        workload.range_select_proportion = (*j_workload).value("range_select_proportion", 0.0);
-        workload.scan_proportion = (*j_workload).value("scan_proportion", 0.0);
-
-        workload.start_key = (*j_workload).value("start_key", 0);
-        workload.key_dist = parse_distribution((*j_workload).value("key_dist", "uniform"));
-        if (workload.key_dist == distribution_kind_t::unknown_k) {
-            workloads.clear();
-            return false;
-        }
-
-        workload.value_length = (*j_workload).value("value_length", 0);
-        workload.value_length_dist = parse_distribution((*j_workload).value("value_length_dist", "const"));
-        if (workload.value_length_dist == distribution_kind_t::unknown_k) {
+        if (!parse_workload(j_workload, workload)) {
             workloads.clear();
             return false;
         }
 
-        workload.batch_upsert_min_length = (*j_workload).value("batch_upsert_min_length", 0);
-        workload.batch_upsert_max_length = (*j_workload).value("batch_upsert_max_length", 0);
-        workload.batch_upsert_length_dist =
-            parse_distribution((*j_workload).value("batch_upsert_length_dist", "uniform"));
-        if (workload.batch_upsert_length_dist == distribution_kind_t::unknown_k) {
-            workloads.clear();
-            return false;
-        }
-
-        workload.batch_read_min_length = (*j_workload).value("batch_read_min_length", 0);
-        workload.batch_read_max_length = (*j_workload).value("batch_read_max_length", 0);
-        workload.batch_read_length_dist = parse_distribution((*j_workload).value("batch_read_length_dist", "uniform"));
-        if (workload.batch_read_length_dist == distribution_kind_t::unknown_k) {
-            workloads.clear();
-            return false;
+        auto j_phases = j_workload.value("phases", json::array());
+        for (size_t phase_idx = 0; phase_idx != j_phases.size(); ++phase_idx) {
+            workload_t phase;
+            if (!parse_nested_workload(j_workload, j_phases[phase_idx], phase)) {
+                workloads.clear();
+                return false;
+            }
+            phase.name = j_phases[phase_idx].value("name", fmt::format("phase_{}", phase_idx + 1));
+            workload.phases.push_back(phase);
         }
 
-        workload.bulk_load_min_length = (*j_workload).value("bulk_load_min_length", 0);
-        workload.bulk_load_max_length = (*j_workload).value("bulk_load_max_length", 0);
-        workload.bulk_load_length_dist = parse_distribution((*j_workload).value("bulk_load_length_dist", "uniform"));
-        if (workload.bulk_load_length_dist == distribution_kind_t::unknown_k) {
-            workloads.clear();
-            return false;
-        }
-
-        workload.range_select_min_length = (*j_workload).value("range_select_min_length", 0);
-        workload.range_select_max_length = (*j_workload).value("range_select_max_length", 0);
-        workload.range_select_length_dist =
-            parse_distribution((*j_workload).value("range_select_length_dist", "uniform"));
-        if (workload.key_dist == distribution_kind_t::unknown_k) {
-            workloads.clear();
-            return false;
+        // Note: Tenants keep the name of the workload, so all their threads report as a single benchmark
+        auto j_tenants = j_workload.value("tenants", json::array());
+        for (size_t tenant_idx = 0; tenant_idx != j_tenants.size(); ++tenant_idx) {
+            workload_t tenant;
+            if (!parse_nested_workload(j_workload, j_tenants[tenant_idx], tenant)) {
+                workloads.clear();
+                return false;
+            }
+            tenant.name = workload.name;
+            tenant.tenant = j_tenants[tenant_idx].value("name", fmt::format("tenant_{}", tenant_idx + 1));
+            tenant.threads_count = j_tenants[tenant_idx].value("threads_count", size_t(1));
+            workload.tenants.push_back(tenant);
         }
 
         workloads.push_back(workload);
@@ -98,16 +98,23 @@ namespace ucsb::filekv
 
     private:
         fs::path data_dir_;
+        db_hints_t hints_;
     };
 
     inline void filekv_t::set_config(fs::path const& config_path, fs::path const& main_dir_path,
                                      std::vector<fs::path> const& storage_dir_paths, db_hints_t const& hints)
     {
         data_dir_ = main_dir_path / "kv_data";
+        hints_ = hints;
     }
 
     inline bool filekv_t::open(std::string& error)
     {
+        if (!hints_.key_encoding.is_fixed())
+        {
+            error = "Supports only fixed integer keys";
+            return false;
+        }
         std::error_code ec;
         if (!fs::exists(data_dir_))
             fs::create_directories(data_dir_, ec);
@@ -17,6 +17,7 @@
 #include "src/core/types.hpp"
 #include "src/core/db.hpp"
 #include "src/core/helper.hpp"
+#include "src/core/key_encoding.hpp"
 
 namespace ucsb::google {
 
@@ -33,8 +34,10 @@ using operation_status_t = ucsb::operation_status_t;
 using operation_result_t = ucsb::operation_result_t;
 using db_hints_t = ucsb::db_hints_t;
 using transaction_t = ucsb::transaction_t;
+using key_encoder_t = ucsb::key_encoder_t;
+using encoded_key_t = ucsb::encoded_key_t;
 
-inline leveldb::Slice to_slice(key_t& key) { return {reinterpret_cast<char const*>(&key), sizeof(key_t)}; }
+inline leveldb::Slice to_slice(encoded_key_t const& key) { return {key.data(), key.size()}; }
 
 inline leveldb::Slice to_slice(value_spanc_t value) {
     return {reinterpret_cast<char const*>(value.data()), value.size()};
@@ -115,15 +118,17 @@ class leveldb_t : public ucsb::db_t {
 
     std::unique_ptr<leveldb::DB> db_;
     key_comparator_t key_cmp_;
+    key_encoder_t key_encoder_;
 };
 
 void leveldb_t::set_config(fs::path const& config_path,
                            fs::path const& main_dir_path,
                            std::vector<fs::path> const& storage_dir_paths,
-                           [[maybe_unused]] db_hints_t const& hints) {
+                           db_hints_t const& hints) {
     config_path_ = config_path;
     main_dir_path_ = main_dir_path;
     storage_dir_paths_ = storage_dir_paths;
+    key_encoder_ = key_encoder_t(hints.key_encoding);
 }
 
 bool leveldb_t::open(std::string& error) {
@@ -170,25 +175,25 @@ bool leveldb_t::open(std::string& error) {
 void leveldb_t::close() { db_.reset(nullptr); }
 
 operation_result_t leveldb_t::upsert(key_t key, value_spanc_t value) {
-    leveldb::Status status = db_->Put(write_options_, to_slice(key), to_slice(value));
+    leveldb::Status status = db_->Put(write_options_, to_slice(encoded_key_t(key, key_encoder_)), to_slice(value));
     return {size_t(status.ok()), status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
 }
 
 operation_result_t leveldb_t::update(key_t key, value_spanc_t value) {
 
     std::string data;
-    leveldb::Status status = db_->Get(read_options_, to_slice(key), &data);
+    leveldb::Status status = db_->Get(read_options_, to_slice(encoded_key_t(key, key_encoder_)), &data);
     if (status.IsNotFound())
         return {0, operation_status_t::not_found_k};
     else if (!status.ok())
         return {0, operation_status_t::error_k};
 
-    status = db_->Put(write_options_, to_slice(key), to_slice(value));
+    status = db_->Put(write_options_, to_slice(encoded_key_t(key, key_encoder_)), to_slice(value));
     return {size_t(status.ok()), status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
 }
 
 operation_result_t leveldb_t::remove(key_t key) {
-    leveldb::Status status = db_->Delete(write_options_, to_slice(key));
+    leveldb::Status status = db_->Delete(write_options_, to_slice(encoded_key_t(key, key_encoder_)));
     return {size_t(status.ok()), status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
 }
 
@@ -197,7 +202,7 @@ operation_result_t leveldb_t::read(key_t key, value_span_t value) const {
     // Unlike RocksDB, we can't read into some form of a `PinnableSlice`,
     // just `std::string`, causing heap allocations.
     std::string data;
-    leveldb::Status status = db_->Get(read_options_, to_slice(key), &data);
+    leveldb::Status status = db_->Get(read_options_, to_slice(encoded_key_t(key, key_encoder_)), &data);
     if (status.IsNotFound())
         return {0, operation_status_t::not_found_k};
     else if (!status.ok())
@@ -213,7 +218,7 @@ operation_result_t leveldb_t::batch_upsert(keys_spanc_t keys, values_spanc_t val
     leveldb::WriteBatch batch;
     for (size_t idx = 0; idx < keys.size(); ++idx) {
         key_t key = keys[idx];
-        batch.Put(to_slice(key), to_slice(values.subspan(offset, sizes[idx])));
+        batch.Put(to_slice(encoded_key_t(key, key_encoder_)), to_slice(values.subspan(offset, sizes[idx])));
         offset += sizes[idx];
     }
 
@@ -228,7 +233,7 @@ operation_result_t leveldb_t::batch_read(keys_spanc_t keys, values_span_t values
     size_t found_cnt = 0;
     for (auto key : keys) {
         std::string data;
-        leveldb::Status status = db_->Get(read_options_, to_slice(key), &data);
+        leveldb::Status status = db_->Get(read_options_, to_slice(encoded_key_t(key, key_encoder_)), &data);
         if (status.ok()) {
             memcpy(values.data() + offset, data.data(), data.size());
             offset += data.size();
@@ -253,7 +258,7 @@ operation_result_t leveldb_t::range_select(key_t key, size_t length, values_span
     size_t i = 0;
     size_t exported_bytes = 0;
     std::unique_ptr<leveldb::Iterator> it(db_->NewIterator(read_options_));
-    it->Seek(to_slice(key));
+    it->Seek(to_slice(encoded_key_t(key, key_encoder_)));
     for (; it->Valid() && i != length; i++, it->Next()) {
         memcpy(values.data() + exported_bytes, it->value().data(), it->value().size());
         exported_bytes += it->value().size();
@@ -267,7 +272,7 @@ operation_result_t leveldb_t::scan(key_t key, size_t length, value_span_t single
     leveldb::ReadOptions scan_options = read_options_;
     scan_options.fill_cache = false;
     std::unique_ptr<leveldb::Iterator> it(db_->NewIterator(scan_options));
-    it->Seek(to_slice(key));
+    it->Seek(to_slice(encoded_key_t(key, key_encoder_)));
     for (; it->Valid() && i != length; i++, it->Next())
         memcpy(single_value.data(), it->value().data(), it->value().size());
     return {i, operation_status_t::ok_k};
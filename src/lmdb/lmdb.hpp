@@ -12,6 +12,7 @@
 #include "src/core/types.hpp"
 #include "src/core/db.hpp"
 #include "src/core/helper.hpp"
+#include "src/core/key_encoding.hpp"
 
 namespace ucsb::symas {
 
@@ -28,6 +29,8 @@ using operation_status_t = ucsb::operation_status_t;
 using operation_result_t = ucsb::operation_result_t;
 using db_hints_t = ucsb::db_hints_t;
 using transaction_t = ucsb::transaction_t;
+using key_encoder_t = ucsb::key_encoder_t;
+using encoded_key_t = ucsb::encoded_key_t;
 
 /**
  * @brief LMDB wrapper for the UCSB benchmark.
@@ -80,11 +83,16 @@ class lmdb_t : public ucsb::db_t {
     fs::path config_path_;
     fs::path main_dir_path_;
     std::vector<fs::path> storage_dir_paths_;
+    key_encoder_t key_encoder_;
 
     MDB_env* env_;
     MDB_dbi dbi_;
 };
 
+inline static MDB_val to_val(encoded_key_t const& key) noexcept {
+    return {key.size(), const_cast<char*>(key.data())};
+}
+
 inline static int compare_keys(MDB_val const* left, MDB_val const* right) noexcept {
     key_t left_key = *reinterpret_cast<key_t const*>(left->mv_data);
     key_t right_key = *reinterpret_cast<key_t const*>(right->mv_data);
@@ -94,10 +102,11 @@ inline static int compare_keys(MDB_val const* left, MDB_val const* right) noexce
 void lmdb_t::set_config(fs::path const& config_path,
                         fs::path const& main_dir_path,
                         std::vector<fs::path> const& storage_dir_paths,
-                        [[maybe_unused]] db_hints_t const& hints) {
+                        db_hints_t const& hints) {
     config_path_ = config_path;
     main_dir_path_ = main_dir_path;
     storage_dir_paths_ = storage_dir_paths;
+    key_encoder_ = key_encoder_t(hints.key_encoding);
 }
 
 bool lmdb_t::open(std::string& error) {
@@ -185,8 +194,8 @@ operation_result_t lmdb_t::upsert(key_t key, value_spanc_t value) {
     MDB_txn* txn = nullptr;
     MDB_val key_slice, val_slice;
 
-    key_slice.mv_data = &key;
-    key_slice.mv_size = sizeof(key_t);
+    encoded_key_t encoded_key(key, key_encoder_);
+    key_slice = to_val(encoded_key);
 
     val_slice.mv_data = const_cast<void*>(reinterpret_cast<void const*>(value.data()));
     val_slice.mv_size = value.size();
@@ -209,8 +218,8 @@ operation_result_t lmdb_t::update(key_t key, value_spanc_t value) {
     MDB_txn* txn = nullptr;
     MDB_val key_slice, val_slice;
 
-    key_slice.mv_data = &key;
-    key_slice.mv_size = sizeof(key_t);
+    encoded_key_t encoded_key(key, key_encoder_);
+    key_slice = to_val(encoded_key);
 
     int res = mdb_txn_begin(env_, nullptr, MDB_RDONLY, &txn);
     if (res)
@@ -240,8 +249,8 @@ operation_result_t lmdb_t::remove(key_t key) {
     MDB_txn* txn = nullptr;
     MDB_val key_slice;
 
-    key_slice.mv_data = &key;
-    key_slice.mv_size = sizeof(key_t);
+    encoded_key_t encoded_key(key, key_encoder_);
+    key_slice = to_val(encoded_key);
 
     int res = mdb_txn_begin(env_, nullptr, 0, &txn);
     if (res)
@@ -261,8 +270,8 @@ operation_result_t lmdb_t::read(key_t key, value_span_t value) const {
     MDB_txn* txn = nullptr;
     MDB_val key_slice, val_slice;
 
-    key_slice.mv_data = &key;
-    key_slice.mv_size = sizeof(key_t);
+    encoded_key_t encoded_key(key, key_encoder_);
+    key_slice = to_val(encoded_key);
 
     int res = mdb_txn_begin(env_, nullptr, MDB_RDONLY, &txn);
     if (res)
@@ -291,9 +300,8 @@ operation_result_t lmdb_t::batch_upsert(keys_spanc_t keys, values_spanc_t values
     size_t offset = 0;
     for (size_t idx = 0; idx < keys.size(); ++idx) {
         MDB_val key_slice, val_slice;
-        auto key = keys[idx];
-        key_slice.mv_data = &key;
-        key_slice.mv_size = sizeof(key_t);
+        encoded_key_t key(keys[idx], key_encoder_);
+        key_slice = to_val(key);
         val_slice.mv_data = const_cast<void*>(reinterpret_cast<void const*>(values.data() + offset));
         val_slice.mv_size = sizes[idx];
 
@@ -323,8 +331,8 @@ operation_result_t lmdb_t::batch_read(keys_spanc_t keys, values_span_t values) c
     size_t offset = 0;
     size_t found_cnt = 0;
     for (auto key : keys) {
-        key_slice.mv_data = &key;
-        key_slice.mv_size = sizeof(key_t);
+        encoded_key_t encoded_key(key, key_encoder_);
+        key_slice = to_val(encoded_key);
         res = mdb_get(txn, dbi_, &key_slice, &val_slice);
         if (res == 0) {
             memcpy(values.data() + offset, val_slice.mv_data, val_slice.mv_size);
@@ -348,8 +356,8 @@ operation_result_t lmdb_t::range_select(key_t key, size_t length, values_span_t
     MDB_cursor* cursor = nullptr;
     MDB_val key_slice, val_slice;
 
-    key_slice.mv_data = &key;
-    key_slice.mv_size = sizeof(key_t);
+    encoded_key_t encoded_key(key, key_encoder_);
+    key_slice = to_val(encoded_key);
 
     int res = mdb_txn_begin(env_, nullptr, 0, &txn);
     if (res)
@@ -386,8 +394,8 @@ operation_result_t lmdb_t::scan(key_t key, size_t length, value_span_t single_va
     MDB_cursor* cursor = nullptr;
     MDB_val key_slice, val_slice;
 
-    key_slice.mv_data = &key;
-    key_slice.mv_size = sizeof(key_t);
+    encoded_key_t encoded_key(key, key_encoder_);
+    key_slice = to_val(encoded_key);
 
     int res = mdb_txn_begin(env_, nullptr, 0, &txn);
     if (res)
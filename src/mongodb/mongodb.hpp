@@ -84,6 +84,7 @@ class mongodb_t : public ucsb::db_t {
     fs::path config_path_;
     fs::path main_dir_path_;
     std::vector<fs::path> storage_dir_paths_;
+    db_hints_t hints_;
 
     mongocxx::instance inst_;
     std::unique_ptr<mongocxx::pool> pool_;
@@ -116,10 +117,11 @@ static void exec_cmd(const char* cmd) {
 void mongodb_t::set_config(fs::path const& config_path,
                            fs::path const& main_dir_path,
                            std::vector<fs::path> const& storage_dir_paths,
-                           [[maybe_unused]] db_hints_t const& hints) {
+                           db_hints_t const& hints) {
     config_path_ = config_path;
     main_dir_path_ = main_dir_path;
     storage_dir_paths_ = storage_dir_paths;
+    hints_ = hints;
     coll_name = main_dir_path.parent_path().filename();
 };
 
@@ -129,6 +131,11 @@ bool mongodb_t::open(std::string& error) {
         error = "Doesn't support multiple disks";
         return false;
     }
+    // Keys are packed into object IDs
+    if (!hints_.key_encoding.is_fixed()) {
+        error = "Supports only fixed integer keys";
+        return false;
+    }
 
     std::string start_cmd = "mongod --config ";
     start_cmd += config_path_;
@@ -92,17 +92,24 @@ namespace ucsb::plain
         std::unique_ptr<std::unordered_map<key_t, value_spanc_t>> map_;
         mutable std::mutex map_lock_;
         fs::path save_path;
+        db_hints_t hints_;
     };
 
     inline void plainhash_t::set_config(fs::path const& config_path, fs::path const& main_dir_path,
                                         std::vector<fs::path> const& storage_dir_paths,
-                                        [[maybe_unused]] db_hints_t const& hints)
+                                        db_hints_t const& hints)
     {
         save_path = main_dir_path / "data.json";
+        hints_ = hints;
     }
 
     inline bool plainhash_t::open(std::string& error)
     {
+        if (!hints_.key_encoding.is_fixed())
+        {
+            error = "Supports only fixed integer keys";
+            return false;
+        }
         if (!fs::exists(save_path))
         {
             return true;
@@ -9,6 +9,7 @@
 #include "src/core/types.hpp"
 #include "src/core/db.hpp"
 #include "src/core/helper.hpp"
+#include "src/core/key_encoding.hpp"
 
 namespace ucsb::redis {
 
@@ -26,6 +27,14 @@ using operation_status_t = ucsb::operation_status_t;
 using operation_result_t = ucsb::operation_result_t;
 using db_hints_t = ucsb::db_hints_t;
 using transaction_t = ucsb::transaction_t;
+using key_encoder_t = ucsb::key_encoder_t;
+using encoded_key_t = ucsb::encoded_key_t;
+
+/*
+ * @brief Preallocated buffers used for batch operations.
+ * Commands reference the keys till they are sent, so they are encoded in advance.
+ */
+thread_local std::vector<encoded_key_t> batch_keys;
 
 /**
  * @brief Redis wrapper for the UCSB benchmark.
@@ -73,9 +82,12 @@ struct redis_t : public ucsb::db_t {
     std::string exec_cmd(const char* cmd);
 
   private:
+    encoded_key_t const* encode_keys(keys_spanc_t keys) const;
+
     fs::path config_path_;
     fs::path main_dir_path_;
     std::vector<fs::path> storage_dir_paths_;
+    key_encoder_t key_encoder_;
 
     std::unique_ptr<sw::redis::Redis> redis_;
     sw::redis::ConnectionOptions connection_options_;
@@ -87,8 +99,14 @@ inline sw::redis::StringView to_string_view(std::byte const* p, size_t size_byte
     return {reinterpret_cast<const char*>(p), size_bytes};
 }
 
-inline sw::redis::StringView to_string_view(key_t const& k) noexcept {
-    return {reinterpret_cast<const char*>(&k), sizeof(key_t)};
+inline sw::redis::StringView to_string_view(encoded_key_t const& key) noexcept { return {key.data(), key.size()}; }
+
+encoded_key_t const* redis_t::encode_keys(keys_spanc_t keys) const {
+    if (keys.size() > batch_keys.size())
+        batch_keys.resize(keys.size());
+    for (size_t idx = 0; idx != keys.size(); ++idx)
+        batch_keys[idx] = encoded_key_t(keys[idx], key_encoder_);
+    return batch_keys.data();
 }
 
 std::string redis_t::exec_cmd(const char* cmd) {
@@ -126,10 +144,11 @@ void redis_t::get_options(fs::path const& path) {
 void redis_t::set_config(fs::path const& config_path,
                          fs::path const& main_dir_path,
                          std::vector<fs::path> const& storage_dir_paths,
-                         [[maybe_unused]] db_hints_t const& hints) {
+                         db_hints_t const& hints) {
     config_path_ = config_path;
     main_dir_path_ = main_dir_path;
     storage_dir_paths_ = storage_dir_paths;
+    key_encoder_ = key_encoder_t(hints.key_encoding);
 }
 
 bool redis_t::open(std::string& error) {
@@ -155,22 +174,24 @@ bool redis_t::open(std::string& error) {
 void redis_t::close() {}
 
 operation_result_t redis_t::upsert(key_t key, value_spanc_t value) {
-    auto status = (*redis_).hset("hash", to_string_view(key), to_string_view(value.data(), value.size()));
+    encoded_key_t encoded_key(key, key_encoder_);
+    auto status = (*redis_).hset("hash", to_string_view(encoded_key), to_string_view(value.data(), value.size()));
     return {size_t(status), status ? operation_status_t::ok_k : operation_status_t::error_k};
 }
 
 operation_result_t redis_t::update(key_t key, value_spanc_t value) {
-    auto status = (*redis_).hset("hash", to_string_view(key), to_string_view(value.data(), value.size()));
+    encoded_key_t encoded_key(key, key_encoder_);
+    auto status = (*redis_).hset("hash", to_string_view(encoded_key), to_string_view(value.data(), value.size()));
     return {status, status ? operation_status_t::ok_k : operation_status_t::not_found_k};
 }
 
 operation_result_t redis_t::remove(key_t key) {
-    size_t count = (*redis_).hdel("hash", to_string_view(key));
+    size_t count = (*redis_).hdel("hash", to_string_view(encoded_key_t(key, key_encoder_)));
     return {count, count ? operation_status_t::ok_k : operation_status_t::not_found_k};
 }
 
 operation_result_t redis_t::read(key_t key, value_span_t value) const {
-    auto val = (*redis_).hget("hash", to_string_view(key));
+    auto val = (*redis_).hget("hash", to_string_view(encoded_key_t(key, key_encoder_)));
     if (!val)
         return {0, operation_status_t::not_found_k};
 
@@ -182,12 +203,12 @@ operation_result_t redis_t::batch_upsert(keys_spanc_t keys, values_spanc_t value
     struct kv_iterator_t {
         using pair_t = std::pair<sw::redis::StringView, sw::redis::StringView>;
         using val_t = typename values_spanc_t::element_type;
-        key_t const* key_ptr_;
+        encoded_key_t const* key_ptr_;
         val_t* val_ptr_;
         value_length_t const* size_ptr_;
         pair_t pair_;
 
-        kv_iterator_t(key_t const* key_ptr, val_t const* val_ptr, value_length_t const* size_ptr) noexcept
+        kv_iterator_t(encoded_key_t const* key_ptr, val_t const* val_ptr, value_length_t const* size_ptr) noexcept
             : key_ptr_(key_ptr), val_ptr_(val_ptr), size_ptr_(size_ptr),
               pair_(std::make_pair(to_string_view(*key_ptr_), to_string_view(val_ptr_, *size_ptr_))) {}
 
@@ -205,18 +226,19 @@ operation_result_t redis_t::batch_upsert(keys_spanc_t keys, values_spanc_t value
         }
     };
 
+    encoded_key_t const* encoded_keys = encode_keys(keys);
     (*redis_).hmset(
         "hash",
-        kv_iterator_t(keys.data(), values.data(), sizes.data()),
-        kv_iterator_t(keys.data() + keys.size(), values.data() + values.size(), sizes.data() + sizes.size()));
+        kv_iterator_t(encoded_keys, values.data(), sizes.data()),
+        kv_iterator_t(encoded_keys + keys.size(), values.data() + values.size(), sizes.data() + sizes.size()));
     return {keys.size(), operation_status_t::ok_k};
 }
 
 operation_result_t redis_t::batch_read(keys_spanc_t keys, values_span_t values) const {
     struct key_iterator_t {
-        key_t const* key_ptr_;
+        encoded_key_t const* key_ptr_;
 
-        key_iterator_t(key_t const* key_ptr) noexcept : key_ptr_(key_ptr) {}
+        key_iterator_t(encoded_key_t const* key_ptr) noexcept : key_ptr_(key_ptr) {}
         sw::redis::StringView operator*() const noexcept { return to_string_view(*key_ptr_); }
         bool operator==(key_iterator_t const& other) const noexcept { return key_ptr_ == other.key_ptr_; }
 
@@ -245,9 +267,10 @@ operation_result_t redis_t::batch_read(keys_spanc_t keys, values_span_t values)
     };
 
     value_getter_t getter(values);
+    encoded_key_t const* encoded_keys = encode_keys(keys);
     (*redis_).hmget("hash",
-                    key_iterator_t(keys.data()),
-                    key_iterator_t(keys.data() + keys.size()),
+                    key_iterator_t(encoded_keys),
+                    key_iterator_t(encoded_keys + keys.size()),
                     std::back_inserter(getter));
     return {getter.count, getter.count ? operation_status_t::ok_k : operation_status_t::error_k};
 }
@@ -255,8 +278,9 @@ operation_result_t redis_t::batch_read(keys_spanc_t keys, values_span_t values)
 operation_result_t redis_t::bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) {
     auto data_offset = 0;
     auto pipe = (*redis_).pipeline(false);
+    encoded_key_t const* encoded_keys = encode_keys(keys);
     for (size_t i = 0; i != keys.size(); ++i) {
-        pipe.hset("hash", to_string_view(keys[i]), to_string_view(values.data() + data_offset, sizes[i]));
+        pipe.hset("hash", to_string_view(encoded_keys[i]), to_string_view(values.data() + data_offset, sizes[i]));
         data_offset += sizes[i];
     }
 
@@ -48,7 +48,7 @@ enum class db_mode_t {
  * @brief Preallocated buffers used for batch operations.
  * Globals and especially `thread_local`s are a bad practice.
  */
-thread_local std::vector<key_t> batch_keys;
+thread_local std::vector<encoded_key_t> batch_keys;
 thread_local std::vector<rocksdb::Slice> key_slices;
 thread_local std::vector<rocksdb::PinnableSlice> value_slices;
 thread_local std::vector<rocksdb::Status> statuses;
@@ -99,6 +99,7 @@ class rocksdb_t : public ucsb::db_t {
     fs::path main_dir_path_;
     std::vector<fs::path> storage_dir_paths_;
     db_hints_t hints_;
+    key_encoder_t key_encoder_;
 
     bool load_additional_options();
 
@@ -139,6 +140,12 @@ void rocksdb_t::set_config(fs::path const& config_path,
     main_dir_path_ = main_dir_path;
     storage_dir_paths_ = storage_dir_paths;
     hints_ = hints;
+
+    // Note: Integer keys are stored big-endian, so the default byte-wise comparator orders them as numbers
+    ucsb::key_encoding_t key_encoding = hints.key_encoding;
+    if (key_encoding.is_fixed())
+        key_encoding.format = ucsb::key_format_t::big_endian_k;
+    key_encoder_ = key_encoder_t(key_encoding);
 }
 
 bool rocksdb_t::open(std::string& error) {
@@ -208,34 +215,33 @@ void rocksdb_t::close() {
 }
 
 operation_result_t rocksdb_t::upsert(key_t key, value_spanc_t value) {
-    rocksdb::Status status = db_->Put(write_options_, to_slice(key), to_slice(value));
+    rocksdb::Status status = db_->Put(write_options_, to_slice(encoded_key_t(key, key_encoder_)), to_slice(value));
     return {size_t(status.ok()), status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
 }
 
 operation_result_t rocksdb_t::update(key_t key, value_spanc_t value) {
 
-    key_t key_to_read = key;
-    key_t key_to_write = key;
-
+    encoded_key_t encoded_key(key, key_encoder_);
     rocksdb::PinnableSlice data;
-    rocksdb::Status status = db_->Get(read_options_, cf_handles_.front(), to_slice(key_to_read), &data);
+    rocksdb::Status status = db_->Get(read_options_, cf_handles_.front(), to_slice(encoded_key), &data);
     if (status.IsNotFound())
         return {0, operation_status_t::not_found_k};
     else if (!status.ok())
         return {0, operation_status_t::error_k};
 
-    status = db_->Put(write_options_, to_slice(key_to_write), to_slice(value));
+    status = db_->Put(write_options_, to_slice(encoded_key), to_slice(value));
     return {size_t(status.ok()), status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
 }
 
 operation_result_t rocksdb_t::remove(key_t key) {
-    rocksdb::Status status = db_->Delete(write_options_, to_slice(key));
+    rocksdb::Status status = db_->Delete(write_options_, to_slice(encoded_key_t(key, key_encoder_)));
     return {size_t(status.ok()), status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
 }
 
 operation_result_t rocksdb_t::read(key_t key, value_span_t value) const {
     rocksdb::PinnableSlice data;
-    rocksdb::Status status = db_->Get(read_options_, cf_handles_.front(), to_slice(key), &data);
+    rocksdb::Status status =
+        db_->Get(read_options_, cf_handles_.front(), to_slice(encoded_key_t(key, key_encoder_)), &data);
     if (status.IsNotFound())
         return {0, operation_status_t::not_found_k};
     else if (!status.ok())
@@ -250,8 +256,7 @@ operation_result_t rocksdb_t::batch_upsert(keys_spanc_t keys, values_spanc_t val
     size_t offset = 0;
     rocksdb::WriteBatch batch;
     for (size_t idx = 0; idx != keys.size(); ++idx) {
-        key_t key = keys[idx];
-        batch.Put(to_slice(key), to_slice(values.subspan(offset, sizes[idx])));
+        batch.Put(to_slice(encoded_key_t(keys[idx], key_encoder_)), to_slice(values.subspan(offset, sizes[idx])));
         offset += sizes[idx];
     }
     rocksdb::Status status = db_->Write(write_options_, &batch);
@@ -268,7 +273,7 @@ operation_result_t rocksdb_t::batch_read(keys_spanc_t keys, values_span_t values
     }
 
     for (size_t idx = 0; idx != keys.size(); ++idx)
-        key_slices[idx] = to_slice(batch_keys[idx] = keys[idx]);
+        key_slices[idx] = to_slice(batch_keys[idx] = encoded_key_t(keys[idx], key_encoder_));
 
     db_->MultiGet(read_options_,
                   cf_handles_.front(),
@@ -311,7 +316,7 @@ operation_result_t rocksdb_t::bulk_load(keys_spanc_t keys, values_spanc_t values
             break;
 
         for (; idx != keys.size(); ++idx) {
-            auto key = keys[idx];
+            encoded_key_t key(keys[idx], key_encoder_);
             status = sst_file_writer.Put(to_slice(key), to_slice(values.subspan(data_offset, sizes[idx])));
             if (!status.ok())
                 break;
@@ -348,7 +353,7 @@ operation_result_t rocksdb_t::range_select(key_t key, size_t length, values_span
     size_t i = 0;
     size_t exported_bytes = 0;
     std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(read_options_));
-    it->Seek(to_slice(key));
+    it->Seek(to_slice(encoded_key_t(key, key_encoder_)));
     for (; it->Valid() && i != length; i++, it->Next()) {
         memcpy(values.data() + exported_bytes, it->value().data(), it->value().size());
         exported_bytes += it->value().size();
@@ -364,7 +369,7 @@ operation_result_t rocksdb_t::scan(key_t key, size_t length, value_span_t single
     // https://github.com/facebook/rocksdb/blob/49a10feb21dc5c766bb272406136667e1d8a969e/include/rocksdb/options.h#L1462
     scan_options.fill_cache = false;
     std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(read_options_));
-    it->Seek(to_slice(key));
+    it->Seek(to_slice(encoded_key_t(key, key_encoder_)));
     for (; it->Valid() && i != length; i++, it->Next())
         memcpy(single_value.data(), it->value().data(), it->value().size());
     return {i, operation_status_t::ok_k};
@@ -391,11 +396,7 @@ size_t rocksdb_t::size_on_disk() const {
 }
 
 std::unique_ptr<transaction_t> rocksdb_t::create_transaction() {
-
-    std::unique_ptr<rocksdb::Transaction> raw(transaction_db_->BeginTransaction(write_options_));
-    auto id = size_t(raw.get());
-    raw->SetName(std::to_string(id));
-    return std::make_unique<rocksdb_transaction_t>(std::move(raw), cf_handles_);
+    return std::make_unique<rocksdb_transaction_t>(transaction_db_, write_options_, cf_handles_, key_encoder_);
 }
 
 bool rocksdb_t::load_additional_options() {
@@ -6,7 +6,8 @@
 #include <rocksdb/utilities/transaction_db.h>
 
 #include "src/core/types.hpp"
-#include "src/core/data_accessor.hpp"
+#include "src/core/db.hpp"
+#include "src/core/key_encoding.hpp"
 
 namespace ucsb::facebook {
 
@@ -21,12 +22,10 @@ using values_spanc_t = ucsb::values_spanc_t;
 using value_lengths_spanc_t = ucsb::value_lengths_spanc_t;
 using operation_status_t = ucsb::operation_status_t;
 using operation_result_t = ucsb::operation_result_t;
+using key_encoder_t = ucsb::key_encoder_t;
+using encoded_key_t = ucsb::encoded_key_t;
 
-inline rocksdb::Slice to_slice(key_t& key) {
-    key = __builtin_bswap64(key);
-    static_assert(sizeof(key_t) == sizeof(uint64_t), "Check `__builtin_bswap64`");
-    return {reinterpret_cast<char const*>(&key), sizeof(key_t)};
-}
+inline rocksdb::Slice to_slice(encoded_key_t const& key) { return {key.data(), key.size()}; }
 
 inline rocksdb::Slice to_slice(value_spanc_t value) {
     return {reinterpret_cast<char const*>(value.data()), value.size()};
@@ -36,7 +35,7 @@ inline rocksdb::Slice to_slice(value_spanc_t value) {
  * @brief Preallocated buffers used for batch operations.
  * Globals and especially `thread_local`s are a bad practice.
  */
-thread_local std::vector<key_t> transaction_batch_keys;
+thread_local std::vector<encoded_key_t> transaction_batch_keys;
 thread_local std::vector<rocksdb::Slice> transaction_key_slices;
 thread_local std::vector<rocksdb::PinnableSlice> transaction_value_slices;
 thread_local std::vector<rocksdb::Status> transaction_statuses;
@@ -48,13 +47,20 @@ thread_local std::vector<rocksdb::Status> transaction_statuses;
  */
 class rocksdb_transaction_t : public ucsb::transaction_t {
   public:
-    inline rocksdb_transaction_t(std::unique_ptr<rocksdb::Transaction> transaction,
-                                 std::vector<rocksdb::ColumnFamilyHandle*> const& cf_handles)
-        : transaction_(std::move(transaction)), cf_handles_(cf_handles) {
+    inline rocksdb_transaction_t(rocksdb::TransactionDB* transaction_db,
+                                 rocksdb::WriteOptions const& write_options,
+                                 std::vector<rocksdb::ColumnFamilyHandle*> const& cf_handles,
+                                 key_encoder_t const& key_encoder)
+        : transaction_db_(transaction_db), write_options_(write_options), cf_handles_(cf_handles),
+          key_encoder_(key_encoder) {
         read_options_.verify_checksums = false;
+        begin();
     }
     ~rocksdb_transaction_t();
 
+    operation_result_t commit() override;
+    void rollback() override;
+
     operation_result_t upsert(key_t key, value_spanc_t value) override;
     operation_result_t update(key_t key, value_spanc_t value) override;
     operation_result_t remove(key_t key) override;
@@ -69,8 +75,13 @@ class rocksdb_transaction_t : public ucsb::transaction_t {
     operation_result_t scan(key_t key, size_t length, value_span_t single_value) const override;
 
   private:
+    void begin();
+
+    rocksdb::TransactionDB* transaction_db_;
+    rocksdb::WriteOptions write_options_;
     std::unique_ptr<rocksdb::Transaction> transaction_;
     std::vector<rocksdb::ColumnFamilyHandle*> cf_handles_;
+    key_encoder_t key_encoder_;
 
     rocksdb::ReadOptions read_options_;
 };
@@ -85,48 +96,55 @@ rocksdb_transaction_t::~rocksdb_transaction_t() {
     assert(status.ok());
 }
 
+void rocksdb_transaction_t::begin() {
+    // Note: The finished transaction is reinitialized instead of allocating a new one
+    transaction_.reset(transaction_db_->BeginTransaction(write_options_, {}, transaction_.release()));
+    auto id = size_t(transaction_.get());
+    transaction_->SetName(std::to_string(id));
+}
+
+operation_result_t rocksdb_transaction_t::commit() {
+    rocksdb::Status status = transaction_->Commit();
+    if (!status.ok())
+        transaction_->Rollback();
+    begin();
+    return {0, status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+void rocksdb_transaction_t::rollback() {
+    transaction_->Rollback();
+    begin();
+}
+
 operation_result_t rocksdb_transaction_t::upsert(key_t key, value_spanc_t value) {
-    auto key_slice = to_slice(key);
+    encoded_key_t encoded_key(key, key_encoder_);
+    auto key_slice = to_slice(encoded_key);
     rocksdb::Status status = transaction_->Put(key_slice, to_slice(value));
-    if (!status.ok()) {
-        assert(status.IsTryAgain());
-        status = transaction_->Commit();
-        assert(status.ok());
-        status = transaction_->Put(key_slice, to_slice(value));
-        assert(status.ok());
-    }
     return {size_t(status.ok()), status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
 }
 
 operation_result_t rocksdb_transaction_t::update(key_t key, value_spanc_t value) {
-    key_t original_key = key;
     rocksdb::PinnableSlice data;
-    rocksdb::Status status = transaction_->Get(read_options_, to_slice(key), &data);
+    rocksdb::Status status = transaction_->Get(read_options_, to_slice(encoded_key_t(key, key_encoder_)), &data);
     if (status.IsNotFound())
         return {0, operation_status_t::not_found_k};
     else if (!status.ok())
         return {0, operation_status_t::error_k};
 
-    return upsert(original_key, value);
+    return upsert(key, value);
 }
 
 operation_result_t rocksdb_transaction_t::remove(key_t key) {
-    auto key_slice = to_slice(key);
+    encoded_key_t encoded_key(key, key_encoder_);
+    auto key_slice = to_slice(encoded_key);
     rocksdb::Status status = transaction_->Delete(key_slice);
-    if (!status.ok()) {
-        assert(status.IsTryAgain());
-        status = transaction_->Commit();
-        assert(status.ok());
-        status = transaction_->Delete(key_slice);
-        assert(status.ok());
-    }
 
     return {size_t(status.ok()), status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
 }
 
 operation_result_t rocksdb_transaction_t::read(key_t key, value_span_t value) const {
     rocksdb::PinnableSlice data;
-    rocksdb::Status status = transaction_->Get(read_options_, to_slice(key), &data);
+    rocksdb::Status status = transaction_->Get(read_options_, to_slice(encoded_key_t(key, key_encoder_)), &data);
     if (status.IsNotFound())
         return {0, operation_status_t::not_found_k};
     else if (!status.ok())
@@ -142,16 +160,12 @@ operation_result_t rocksdb_transaction_t::batch_upsert(keys_spanc_t keys,
 
     size_t offset = 0;
     for (size_t idx = 0; idx < keys.size(); ++idx) {
-        auto key = keys[idx];
-        auto key_slice = to_slice(key);
+        encoded_key_t encoded_key(keys[idx], key_encoder_);
+        auto key_slice = to_slice(encoded_key);
         rocksdb::Status status = transaction_->Put(key_slice, to_slice(values.subspan(offset, sizes[idx])));
-        if (!status.ok()) {
-            assert(status.IsTryAgain());
-            status = transaction_->Commit();
-            assert(status.ok());
-            status = transaction_->Put(key_slice, to_slice(values.subspan(offset, sizes[idx])));
-            assert(status.ok());
-        }
+        // Note: Keys locked by other transactions fail the whole batch
+        if (!status.ok())
+            return {idx, operation_status_t::error_k};
         offset += sizes[idx];
     }
     return {keys.size(), operation_status_t::ok_k};
@@ -167,7 +181,7 @@ operation_result_t rocksdb_transaction_t::batch_read(keys_spanc_t keys, values_s
     }
 
     for (size_t idx = 0; idx < keys.size(); ++idx)
-        transaction_key_slices[idx] = to_slice(transaction_batch_keys[idx] = keys[idx]);
+        transaction_key_slices[idx] = to_slice(transaction_batch_keys[idx] = encoded_key_t(keys[idx], key_encoder_));
 
     transaction_->MultiGet(read_options_,
                            cf_handles_.front(),
@@ -201,7 +215,7 @@ operation_result_t rocksdb_transaction_t::range_select(key_t key, size_t length,
     size_t i = 0;
     size_t exported_bytes = 0;
     std::unique_ptr<rocksdb::Iterator> it(transaction_->GetIterator(read_options_));
-    it->Seek(to_slice(key));
+    it->Seek(to_slice(encoded_key_t(key, key_encoder_)));
     for (; it->Valid() && i != length; i++, it->Next()) {
         memcpy(values.data() + exported_bytes, it->value().data(), it->value().size());
         exported_bytes += it->value().size();
@@ -217,7 +231,7 @@ operation_result_t rocksdb_transaction_t::scan(key_t key, size_t length, value_s
     // https://github.com/facebook/rocksdb/blob/49a10feb21dc5c766bb272406136667e1d8a969e/include/rocksdb/options.h#L1462
     scan_options.fill_cache = false;
     std::unique_ptr<rocksdb::Iterator> it(transaction_->GetIterator(scan_options));
-    it->Seek(to_slice(key));
+    it->Seek(to_slice(encoded_key_t(key, key_encoder_)));
     for (; it->Valid() && i != length; i++, it->Next())
         memcpy(single_value.data(), it->value().data(), it->value().size());
     return {i, operation_status_t::ok_k};
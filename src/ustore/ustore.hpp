@@ -112,6 +112,11 @@ bool ustore_t::open(std::string& error) {
     if (client_)
         return true;
 
+    if (!hints_.key_encoding.is_fixed()) {
+        error = "Supports only fixed integer keys";
+        return false;
+    }
+
     // Read config from file
     std::ifstream stream(config_path_);
     if (!stream) {
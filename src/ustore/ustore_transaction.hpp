@@ -4,7 +4,7 @@
 #include <ustore/cpp/status.hpp>
 
 #include "src/core/types.hpp"
-#include "src/core/data_accessor.hpp"
+#include "src/core/db.hpp"
 
 namespace ucsb::ustore {
 
@@ -33,6 +33,9 @@ class ustore_transact_t : public ucsb::transaction_t {
         : db_(db), transaction_(transaction), arena_(db_) {}
     ~ustore_transact_t();
 
+    operation_result_t commit() override;
+    void rollback() override;
+
     operation_result_t upsert(key_t key, value_spanc_t value) override;
     operation_result_t update(key_t key, value_spanc_t value) override;
     operation_result_t remove(key_t key) override;
@@ -47,7 +50,7 @@ class ustore_transact_t : public ucsb::transaction_t {
     operation_result_t scan(key_t key, size_t length, value_span_t single_value) const override;
 
   private:
-    inline ustore::status_t commit() {
+    inline ustore::status_t commit_transaction() {
         ustore::status_t status;
         ustore_transaction_commit_t txn_commit {};
         txn_commit.db = db_;
@@ -58,6 +61,19 @@ class ustore_transact_t : public ucsb::transaction_t {
         return status;
     }
 
+    /**
+     * @brief Discards the changes of the current transaction, and begins the next one in its place.
+     */
+    inline void reset() {
+        ustore::status_t status;
+        ustore_transaction_init_t txn_init {};
+        txn_init.db = db_;
+        txn_init.error = status.member_ptr();
+        txn_init.transaction = &transaction_;
+        ustore_transaction_init(&txn_init);
+        assert(status);
+    }
+
     ustore_database_t db_;
     ustore_transaction_t transaction_;
     ustore_collection_t collection_ = ustore_collection_main_k;
@@ -66,11 +82,20 @@ class ustore_transact_t : public ucsb::transaction_t {
 };
 
 ustore_transact_t::~ustore_transact_t() {
-    [[maybe_unused]] auto status = commit();
+    [[maybe_unused]] auto status = commit_transaction();
     assert(status);
     ustore_transaction_free(transaction_);
 }
 
+operation_result_t ustore_transact_t::commit() {
+    ustore::status_t status = commit_transaction();
+    bool is_committed = bool(status);
+    reset();
+    return {0, is_committed ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+void ustore_transact_t::rollback() { reset(); }
+
 operation_result_t ustore_transact_t::upsert(key_t key, value_spanc_t value) {
     ustore::status_t status;
     ustore_key_t key_ = key;
@@ -89,10 +114,6 @@ operation_result_t ustore_transact_t::upsert(key_t key, value_spanc_t value) {
     write.lengths = reinterpret_cast<ustore_length_t const*>(&length);
     write.values = value_.member_ptr();
     ustore_write(&write);
-    if (!status && commit()) {
-        status.release_exception();
-        ustore_write(&write);
-    }
 
     return {size_t(status), status ? operation_status_t::ok_k : operation_status_t::error_k};
 }
@@ -133,10 +154,6 @@ operation_result_t ustore_transact_t::remove(key_t key) {
     write.collections = &collection_;
     write.keys = &key_;
     ustore_write(&write);
-    if (!status && commit()) {
-        status.release_exception();
-        ustore_write(&write);
-    }
 
     return {status ? size_t(1) : 0, status ? operation_status_t::ok_k : operation_status_t::error_k};
 }
@@ -195,10 +212,6 @@ operation_result_t ustore_transact_t::batch_upsert(keys_spanc_t keys,
     write.lengths_stride = sizeof(ustore_length_t);
     write.values = values_.member_ptr();
     ustore_write(&write);
-    if (!status && commit()) {
-        status.release_exception();
-        ustore_write(&write);
-    }
 
     return {status ? keys.size() : 0, status ? operation_status_t::ok_k : operation_status_t::error_k};
 }
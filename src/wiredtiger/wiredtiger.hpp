@@ -10,6 +10,7 @@
 #include "src/core/db.hpp"
 #include "src/core/helper.hpp"
 #include "src/core/printable.hpp"
+#include "src/core/key_encoding.hpp"
 
 namespace ucsb::mongo {
 
@@ -26,6 +27,8 @@ using operation_status_t = ucsb::operation_status_t;
 using operation_result_t = ucsb::operation_result_t;
 using db_hints_t = ucsb::db_hints_t;
 using transaction_t = ucsb::transaction_t;
+using key_encoder_t = ucsb::key_encoder_t;
+using encoded_key_t = ucsb::encoded_key_t;
 
 /**
  * @brief WiredTiger wrapper for the UCSB benchmark.
@@ -76,11 +79,21 @@ class wiredtiger_t : public ucsb::db_t {
     inline WT_CURSOR* open_cursor(char const* config = nullptr) const;
     inline void close_cursor(WT_CURSOR* cursor) const;
 
+    /**
+     * @brief Cursors reference the key till the operation completes, so it is kept by the caller.
+     */
+    struct cursor_key_t {
+        encoded_key_t encoded;
+        WT_ITEM item;
+    };
+    inline void set_key(WT_CURSOR* cursor, key_t key, cursor_key_t& cursor_key) const;
+
   private:
     fs::path config_path_;
     fs::path main_dir_path_;
     std::vector<fs::path> storage_dir_paths_;
     db_hints_t hints_;
+    key_encoder_t key_encoder_;
 
     WT_CONNECTION* conn_;
     std::string table_name_;
@@ -114,6 +127,7 @@ void wiredtiger_t::set_config(fs::path const& config_path,
     main_dir_path_ = main_dir_path;
     storage_dir_paths_ = storage_dir_paths;
     hints_ = hints;
+    key_encoder_ = key_encoder_t(hints.key_encoding);
 }
 
 bool wiredtiger_t::open(std::string& error) {
@@ -139,6 +153,9 @@ bool wiredtiger_t::open(std::string& error) {
         return false;
     }
 
+    // Integer keys are stored natively, other keys as byte strings
+    std::string table_config = fmt::format("key_format={},value_format=u", key_encoder_.is_fixed() ? "Q" : "u");
+
     // Create sessions for threads
     sessions_.reserve(hints_.threads_count);
     for (size_t i = 0; i < hints_.threads_count; ++i) {
@@ -147,7 +164,7 @@ bool wiredtiger_t::open(std::string& error) {
         if (res)
             break;
         sessions_.push_back(session);
-        res = session->create(session, table_name_.c_str(), "key_format=Q,value_format=u");
+        res = session->create(session, table_name_.c_str(), table_config.c_str());
         if (res)
             break;
     }
@@ -200,13 +217,25 @@ inline WT_CURSOR* wiredtiger_t::open_cursor(char const* config) const {
 
 inline void wiredtiger_t::close_cursor(WT_CURSOR* cursor) const { cursor->close(cursor); }
 
+inline void wiredtiger_t::set_key(WT_CURSOR* cursor, key_t key, cursor_key_t& cursor_key) const {
+    if (key_encoder_.is_fixed()) {
+        cursor->set_key(cursor, key);
+        return;
+    }
+    cursor_key.encoded = encoded_key_t(key, key_encoder_);
+    cursor_key.item.data = cursor_key.encoded.data();
+    cursor_key.item.size = cursor_key.encoded.size();
+    cursor->set_key(cursor, &cursor_key.item);
+}
+
 operation_result_t wiredtiger_t::upsert(key_t key, value_spanc_t value) {
 
     WT_CURSOR* cursor = open_cursor();
     if (!cursor)
         return {0, operation_status_t::error_k};
 
-    cursor->set_key(cursor, key);
+    cursor_key_t cursor_key;
+    set_key(cursor, key, cursor_key);
     WT_ITEM db_value;
     db_value.data = value.data();
     db_value.size = value.size();
@@ -223,7 +252,8 @@ operation_result_t wiredtiger_t::update(key_t key, value_spanc_t value) {
     if (!cursor)
         return {0, operation_status_t::error_k};
 
-    cursor->set_key(cursor, key);
+    cursor_key_t cursor_key;
+    set_key(cursor, key, cursor_key);
     WT_ITEM db_value;
     db_value.data = value.data();
     db_value.size = value.size();
@@ -240,7 +270,8 @@ operation_result_t wiredtiger_t::remove(key_t key) {
     if (!cursor)
         return {0, operation_status_t::error_k};
 
-    cursor->set_key(cursor, key);
+    cursor_key_t cursor_key;
+    set_key(cursor, key, cursor_key);
     auto res = cursor->remove(cursor);
     close_cursor(cursor);
 
@@ -254,7 +285,8 @@ operation_result_t wiredtiger_t::read(key_t key, value_span_t value) const {
     if (!cursor)
         return {0, operation_status_t::error_k};
 
-    cursor->set_key(cursor, key);
+    cursor_key_t cursor_key;
+    set_key(cursor, key, cursor_key);
     auto res = cursor->search(cursor);
     if (res)
         return {0, operation_status_t::not_found_k};
@@ -279,7 +311,8 @@ operation_result_t wiredtiger_t::batch_upsert(keys_spanc_t keys, values_spanc_t
     size_t offset = 0;
     size_t upserted = 0;
     for (size_t idx = 0; idx < keys.size(); ++idx) {
-        cursor->set_key(cursor, keys[idx]);
+        cursor_key_t cursor_key;
+        set_key(cursor, keys[idx], cursor_key);
         WT_ITEM db_value;
         db_value.data = values.data() + offset;
         db_value.size = sizes[idx];
@@ -305,7 +338,8 @@ operation_result_t wiredtiger_t::batch_read(keys_spanc_t keys, values_span_t val
     size_t found_cnt = 0;
     for (auto key : keys) {
         WT_ITEM db_value;
-        cursor->set_key(cursor, key);
+        cursor_key_t cursor_key;
+        set_key(cursor, key, cursor_key);
         int res = cursor->search(cursor);
         if (res == 0) {
             res = cursor->get_value(cursor, &db_value);
@@ -335,7 +369,8 @@ operation_result_t wiredtiger_t::bulk_load(keys_spanc_t keys, values_spanc_t val
 
     size_t offset = 0;
     for (size_t idx = 0; idx < keys.size(); ++idx) {
-        bulk_load_cursor_->set_key(bulk_load_cursor_, keys[idx]);
+        cursor_key_t cursor_key;
+        set_key(bulk_load_cursor_, keys[idx], cursor_key);
         WT_ITEM db_value;
         db_value.data = &values[offset];
         db_value.size = sizes[idx];
@@ -353,14 +388,16 @@ operation_result_t wiredtiger_t::range_select(key_t key, size_t length, values_s
     if (!cursor)
         return {0, operation_status_t::error_k};
 
-    cursor->set_key(cursor, key);
+    cursor_key_t cursor_key;
+    set_key(cursor, key, cursor_key);
     auto res = cursor->search(cursor);
     if (res)
         return {0, operation_status_t::error_k};
 
     size_t i = 0;
     WT_ITEM db_value;
-    const char* db_key = nullptr;
+    // Note: Big enough for both integer and byte string keys
+    WT_ITEM db_key;
     size_t offset = 0;
     size_t selected_records_count = 0;
     while ((res = cursor->next(cursor)) == 0 && i++ < length) {
@@ -383,14 +420,16 @@ operation_result_t wiredtiger_t::scan(key_t key, size_t length, value_span_t sin
     if (!cursor)
         return {0, operation_status_t::error_k};
 
-    cursor->set_key(cursor, key);
+    cursor_key_t cursor_key;
+    set_key(cursor, key, cursor_key);
     auto res = cursor->search(cursor);
     if (res)
         return {0, operation_status_t::error_k};
 
     size_t i = 0;
     WT_ITEM db_value;
-    const char* db_key = nullptr;
+    // Note: Big enough for both integer and byte string keys
+    WT_ITEM db_key;
     size_t scanned_records_count = 0;
     while ((res = cursor->next(cursor)) == 0 && i++ < length) {
         res = cursor->get_key(cursor, &db_key);